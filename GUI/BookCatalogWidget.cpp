@@ -1,10 +1,12 @@
 #include "bookcatalogwidget.h"
+#include "booktablemodel.h"
 #include "Services/libraryservice.h"
+#include "Services/searchcontroller.h"
 #include "Models/book.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
-#include <QTableWidget>
+#include <QTableView>
 #include <QLineEdit>
 #include <QPushButton>
 #include <QHeaderView>
@@ -18,7 +20,14 @@ BookCatalogWidget::BookCatalogWidget(LibraryService& service, QWidget *parent)
     : QWidget(parent), libraryService(service) {
     setupUI();
     setupConnections();
-    refreshData(); // Tải dữ liệu lần đầu
+    // Hiển thị ảnh chụp của lần chạy trước nếu có (được đối chiếu lại ở nền), nếu không thì tải lần đầu
+    if (!bookModel->restoreSnapshot()) {
+        refreshData();
+    }
+}
+
+void BookCatalogWidget::saveSnapshot() const {
+    bookModel->saveSnapshot();
 }
 
 void BookCatalogWidget::setupUI() {
@@ -35,13 +44,17 @@ void BookCatalogWidget::setupUI() {
     searchLayout->addWidget(refreshButton);
     leftLayout->addLayout(searchLayout);
 
-    bookTable = new QTableWidget();
-    bookTable->setColumnCount(4);
-    bookTable->setHorizontalHeaderLabels({"ISBN", "Tên sách", "Tác giả", "Có sẵn / Tổng"});
+    bookModel = new BookTableModel(libraryService, this);
+    searchController = new SearchController(this);
+    bookTable = new QTableView();
+    bookTable->setModel(bookModel);
+    bookTable->setSelectionMode(QAbstractItemView::SingleSelection);
     bookTable->setSelectionBehavior(QAbstractItemView::SelectRows);
     bookTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
     bookTable->horizontalHeader()->setStretchLastSection(true);
     bookTable->verticalHeader()->setVisible(false);
+    // Mọi dòng cao bằng nhau: view không phải đo từng dòng khi cuộn
+    bookTable->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
     leftLayout->addWidget(bookTable);
 
     auto rightWidget = new QWidget();
@@ -80,10 +93,14 @@ void BookCatalogWidget::setupUI() {
 void BookCatalogWidget::setupConnections() {
     // Sửa: Kết nối tín hiệu dataChanged để tự động cập nhật
     connect(&libraryService, &LibraryService::dataChanged, this, &BookCatalogWidget::refreshData);
+    connect(&libraryService, &LibraryService::bookUpserted, bookModel, &BookTableModel::upsertBook);
+    connect(&libraryService, &LibraryService::bookRemoved, bookModel, &BookTableModel::removeBook);
 
     connect(refreshButton, &QPushButton::clicked, this, &BookCatalogWidget::refreshData);
-    connect(searchEdit, &QLineEdit::textChanged, this, &BookCatalogWidget::onSearchTextChanged);
-    connect(bookTable, &QTableWidget::itemSelectionChanged, this, &BookCatalogWidget::onTableItemSelected);
+    connect(searchEdit, &QLineEdit::textChanged, searchController, &SearchController::setSearchTerm);
+    connect(searchController, &SearchController::cleared, bookModel, &BookTableModel::showCatalog);
+    connect(searchController, &SearchController::resultsReady, bookModel, &BookTableModel::showSearchResults);
+    connect(bookTable->selectionModel(), &QItemSelectionModel::selectionChanged, this, &BookCatalogWidget::onTableItemSelected);
 
     connect(addButton, &QPushButton::clicked, this, &BookCatalogWidget::onAddBook);
     connect(editButton, &QPushButton::clicked, this, &BookCatalogWidget::onEditBook);
@@ -91,24 +108,12 @@ void BookCatalogWidget::setupConnections() {
 }
 
 void BookCatalogWidget::refreshData() {
-    auto books = libraryService.getAllBooks();
-    populateTable(books);
-    clearForm();
-}
-
-void BookCatalogWidget::populateTable(const std::vector<std::unique_ptr<Book>>& books) {
-    bookTable->setRowCount(0);
-    bookTable->blockSignals(true);
-    for (const auto& book : books) {
-        int row = bookTable->rowCount();
-        bookTable->insertRow(row);
-        bookTable->setItem(row, 0, new QTableWidgetItem(book->getIsbn()));
-        bookTable->setItem(row, 1, new QTableWidgetItem(book->getTitle()));
-        bookTable->setItem(row, 2, new QTableWidgetItem(book->getAuthor()));
-        QString copies = QString("%1 / %2").arg(book->getAvailableCopies()).arg(book->getTotalCopies());
-        bookTable->setItem(row, 3, new QTableWidgetItem(copies));
+    if (searchController->searchTerm().isEmpty()) {
+        bookModel->showCatalog();
+    } else {
+        searchController->searchNow();
     }
-    bookTable->blockSignals(false);
+    clearForm();
 }
 
 void BookCatalogWidget::clearForm() {
@@ -123,30 +128,23 @@ void BookCatalogWidget::clearForm() {
 }
 
 void BookCatalogWidget::onTableItemSelected() {
-    int currentRow = bookTable->currentRow();
-    if (currentRow < 0) {
+    const QModelIndexList selected = bookTable->selectionModel()->selectedRows();
+    const std::optional<Book> book = selected.isEmpty() ? std::nullopt : bookModel->bookAt(selected.first().row());
+    if (!book) {
         clearForm();
         return;
     }
 
-    isbnEdit->setText(bookTable->item(currentRow, 0)->text());
-    titleEdit->setText(bookTable->item(currentRow, 1)->text());
-    authorEdit->setText(bookTable->item(currentRow, 2)->text());
-
-    QString copiesText = bookTable->item(currentRow, 3)->text();
-    int totalCopies = copiesText.section('/', 1, 1).trimmed().toInt();
-    totalCopiesSpinBox->setValue(totalCopies);
+    isbnEdit->setText(book->getIsbn());
+    titleEdit->setText(book->getTitle());
+    authorEdit->setText(book->getAuthor());
+    totalCopiesSpinBox->setValue(book->getTotalCopies());
 
     isbnEdit->setReadOnly(true); // Không cho phép sửa ISBN
     editButton->setEnabled(true);
     deleteButton->setEnabled(true);
 }
 
-void BookCatalogWidget::onSearchTextChanged(const QString& text) {
-    auto books = libraryService.searchBooks(text);
-    populateTable(books);
-}
-
 void BookCatalogWidget::onAddBook() {
     QString isbn = isbnEdit->text().trimmed();
     QString title = titleEdit->text().trimmed();
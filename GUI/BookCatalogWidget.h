@@ -2,27 +2,27 @@
 #define BOOKCATALOGWIDGET_H
 
 #include <QWidget>
-#include <memory>
-#include <vector>
 
 // Forward declarations
-class QTableWidget;
+class QTableView;
 class QLineEdit;
 class QPushButton;
 class QSpinBox;
 class LibraryService;
-class Book;
+class BookTableModel;
+class SearchController;
 
 class BookCatalogWidget : public QWidget {
     Q_OBJECT
 public:
     explicit BookCatalogWidget(LibraryService& service, QWidget *parent = nullptr);
+    // Lưu trang đầu danh mục để lần mở sau hiển thị ngay (xem BookTableModel::restoreSnapshot)
+    void saveSnapshot() const;
 
 public slots:
     void refreshData(); // Sửa: Đổi tên thành một slot chung để nhận tín hiệu
 
 private slots:
-    void onSearchTextChanged(const QString& text);
     void onAddBook();
     void onEditBook();
     void onDeleteBook();
@@ -31,11 +31,14 @@ private slots:
 private:
     void setupUI();
     void setupConnections();
-    void populateTable(const std::vector<std::unique_ptr<Book>>& books);
     void clearForm();
 
     // --- UI Components ---
-    QTableWidget* bookTable;
+    QTableView* bookTable;
+    // Nạp sách theo trang khi cuộn; các thay đổi từng sách chỉ cập nhật đúng dòng của nó
+    BookTableModel* bookModel;
+    // Tìm kiếm khi gõ: debounce, chạy trên worker, kết quả về theo lô
+    SearchController* searchController;
     QLineEdit* searchEdit;
     QPushButton* addButton;
     QPushButton* editButton;
@@ -0,0 +1,346 @@
+#include "booktablemodel.h"
+#include "Services/libraryservice.h"
+#include "Services/warmstartcache.h"
+
+#include <QDataStream>
+#include <algorithm>
+#include <utility>
+
+namespace {
+// Số sách đọc mỗi lần cuộn tới cuối bảng
+const int PAGE_SIZE = 200;
+const QString SNAPSHOT_NAME = "book_catalog";
+
+// Trang danh mục đọc trên luồng worker (Page<Book> chứa unique_ptr nên không đi qua QFuture được)
+struct CatalogPage {
+    std::vector<Book> books;
+    PageCursor last;
+    bool hasMore = false;
+};
+
+CatalogPage readCatalogPage(LibraryService& service, const PageCursor& cursor) {
+    Page<Book> page = service.getBooksPage(cursor, PAGE_SIZE);
+    CatalogPage result;
+    result.books.reserve(page.items.size());
+    for (const auto& book : page.items) {
+        result.books.push_back(*book);
+    }
+    result.last = page.last;
+    result.hasMore = page.hasMore;
+    return result;
+}
+
+bool sameRows(const std::vector<Book>& a, const std::vector<Book>& b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const Book& x, const Book& y) {
+        return x.getIsbn() == y.getIsbn() && x.getTitle() == y.getTitle() && x.getAuthor() == y.getAuthor()
+            && x.getTotalCopies() == y.getTotalCopies() && x.getAvailableCopies() == y.getAvailableCopies();
+    });
+}
+}
+
+BookTableModel::BookTableModel(LibraryService& service, QObject* parent)
+    : QAbstractTableModel(parent), libraryService(service) {
+}
+
+int BookTableModel::rowCount(const QModelIndex& parent) const {
+    if (parent.isValid()) return 0;
+    return isSearching() ? searchResults.size() : static_cast<int>(books.size());
+}
+
+int BookTableModel::columnCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant BookTableModel::data(const QModelIndex& index, int role) const {
+    if (role != Qt::DisplayRole || index.row() < 0 || index.row() >= rowCount()) return QVariant();
+
+    if (isSearching()) {
+        // Đọc thẳng từ snapshot; chuỗi chỉ được tạo cho các ô view thực sự vẽ
+        const BookSnapshot::Row row = searchResults[index.row()];
+        switch (index.column()) {
+        case IsbnColumn: return row.isbn().toString();
+        case TitleColumn: return row.title().toString();
+        case AuthorColumn: return row.author().toString();
+        case CopiesColumn: return QString("%1 / %2").arg(row.availableCopies()).arg(row.totalCopies());
+        default: return QVariant();
+        }
+    }
+
+    const Book* book = &books[index.row()];
+    switch (index.column()) {
+    case IsbnColumn: return book->getIsbn();
+    case TitleColumn: return book->getTitle();
+    case AuthorColumn: return book->getAuthor();
+    case CopiesColumn: return QString("%1 / %2").arg(book->getAvailableCopies()).arg(book->getTotalCopies());
+    default: return QVariant();
+    }
+}
+
+QVariant BookTableModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) return QVariant();
+
+    switch (section) {
+    case IsbnColumn: return QString("ISBN");
+    case TitleColumn: return QString("Tên sách");
+    case AuthorColumn: return QString("Tác giả");
+    case CopiesColumn: return QString("Có sẵn / Tổng");
+    default: return QVariant();
+    }
+}
+
+bool BookTableModel::canFetchMore(const QModelIndex& parent) const {
+    return !parent.isValid() && !isSearching() && !reconciling && !fetching && hasMore;
+}
+
+void BookTableModel::fetchMore(const QModelIndex& parent) {
+    if (!canFetchMore(parent)) return;
+
+    // Đọc trên luồng worker để việc cuộn không chặn luồng giao diện
+    fetching = true;
+    const quint64 requestGeneration = generation;
+    const PageCursor cursor = nextCursor;
+    LibraryService* service = &libraryService;
+    DatabaseManager::getInstance().executor().run([service, cursor]() {
+        return readCatalogPage(*service, cursor);
+    }).then(this, [this, requestGeneration](const CatalogPage& page) {
+        if (requestGeneration != generation) return; // nội dung đã được thay trong lúc chờ
+        appendPage(page.books, page.last, page.hasMore);
+    }).onCanceled(this, [this, requestGeneration]() {
+        // Executor đã dừng (đang đóng database): mở lại canFetchMore
+        if (requestGeneration == generation) cancelFetch();
+    });
+}
+
+void BookTableModel::appendPage(std::vector<Book> rows, const PageCursor& last, bool more) {
+    fetching = false;
+    hasMore = more;
+    if (!rows.empty()) nextCursor = last;
+
+    // Sách đã được upsertBook chèn trong lúc chờ không được thêm lần nữa
+    rows.erase(std::remove_if(rows.begin(), rows.end(), [this](const Book& book) {
+        return loadedTitles.contains(book.getIsbn());
+    }), rows.end());
+    if (!rows.empty()) {
+        const int first = static_cast<int>(books.size());
+        beginInsertRows(QModelIndex(), first, first + static_cast<int>(rows.size()) - 1);
+        books.reserve(books.size() + rows.size());
+        for (Book& book : rows) {
+            loadedTitles.insert(book.getIsbn(), book.getTitle());
+            books.push_back(std::move(book));
+        }
+        endInsertRows();
+    }
+
+    const QHash<QString, std::optional<Book>> changes = std::exchange(changesWhileFetching, {});
+    for (auto it = changes.constBegin(); it != changes.constEnd(); ++it) {
+        if (it.value()) {
+            upsertBook(*it.value());
+        } else {
+            removeBook(it.key());
+        }
+    }
+}
+
+void BookTableModel::cancelFetch() {
+    fetching = false;
+    changesWhileFetching.clear();
+}
+
+std::optional<Book> BookTableModel::bookAt(int row) const {
+    if (row < 0 || row >= rowCount()) return std::nullopt;
+    return isSearching() ? searchResults.toBook(row) : books[row];
+}
+
+void BookTableModel::showCatalog() {
+    ++generation;
+    reconciling = false;
+    cancelFetch();
+    beginResetModel();
+    searchTerm.clear();
+    books.clear();
+    searchResults = BookSnapshot();
+    loadedTitles.clear();
+    nextCursor = PageCursor();
+    hasMore = true;
+    endResetModel();
+    // Trang đầu tiên được view yêu cầu qua fetchMore
+}
+
+void BookTableModel::showSearchResults(const QString& term, const BookSnapshot& results, bool replace) {
+    if (replace) {
+        ++generation;
+        reconciling = false;
+        cancelFetch();
+        beginResetModel();
+        searchTerm = term;
+        books.clear();
+        searchResults = BookSnapshot();
+        loadedTitles.clear();
+        hasMore = false;
+        endResetModel();
+    }
+    if (results.isEmpty()) return;
+
+    // Giữ nguyên dạng cột: nối cả lô mà không tạo Book cho từng dòng
+    const int first = searchResults.size();
+    beginInsertRows(QModelIndex(), first, first + results.size() - 1);
+    searchResults.append(results);
+    endInsertRows();
+}
+
+int BookTableModel::rowOf(const QString& isbn) const {
+    if (isSearching()) {
+        // Kết quả tìm kiếm sắp theo mức độ liên quan và có số dòng giới hạn
+        for (int row = 0; row < searchResults.size(); ++row) {
+            if (searchResults[row].isbn() == isbn) return row;
+        }
+        return -1;
+    }
+
+    auto title = loadedTitles.constFind(isbn);
+    if (title == loadedTitles.constEnd()) return -1;
+    const int row = lowerBound(*title, isbn);
+    return row < static_cast<int>(books.size()) && books[row].getIsbn() == isbn ? row : -1;
+}
+
+int BookTableModel::lowerBound(const QString& title, const QString& isbn) const {
+    auto it = std::lower_bound(books.begin(), books.end(), std::make_pair(title, isbn),
+                               [](const Book& book, const std::pair<QString, QString>& key) {
+        return std::make_pair(book.getTitle(), book.getIsbn()) < key;
+    });
+    return static_cast<int>(it - books.begin());
+}
+
+void BookTableModel::upsertBook(const Book& book) {
+    changedWhileReconciling = changedWhileReconciling || reconciling;
+    if (fetching) changesWhileFetching.insert(book.getIsbn(), book);
+    const int existing = rowOf(book.getIsbn());
+
+    if (isSearching()) {
+        // Sách mới chưa chắc khớp từ khóa nên chỉ cập nhật các dòng đang hiển thị
+        if (existing < 0) return;
+        searchResults.replace(existing, book);
+        emit dataChanged(index(existing, 0), index(existing, ColumnCount - 1));
+        return;
+    }
+
+    if (existing >= 0 && books[existing].getTitle() == book.getTitle()) {
+        // Cùng tên sách nên vẫn đúng vị trí, chỉ thay nội dung dòng
+        books[existing] = book;
+        emit dataChanged(index(existing, 0), index(existing, ColumnCount - 1));
+        return;
+    }
+
+    if (existing >= 0) removeBookAt(existing);
+    const int row = lowerBound(book.getTitle(), book.getIsbn());
+    // Đứng sau trang cuối đã nạp: sẽ được đọc cùng trang kế tiếp
+    if (row == static_cast<int>(books.size()) && hasMore) return;
+    insertBookAt(row, book);
+}
+
+void BookTableModel::removeBook(const QString& isbn) {
+    changedWhileReconciling = changedWhileReconciling || reconciling;
+    if (fetching) changesWhileFetching.insert(isbn, std::nullopt);
+    const int row = rowOf(isbn);
+    if (row >= 0) removeBookAt(row);
+}
+
+void BookTableModel::insertBookAt(int row, const Book& book) {
+    beginInsertRows(QModelIndex(), row, row);
+    books.insert(books.begin() + row, book);
+    loadedTitles.insert(book.getIsbn(), book.getTitle());
+    endInsertRows();
+}
+
+void BookTableModel::removeBookAt(int row) {
+    beginRemoveRows(QModelIndex(), row, row);
+    if (isSearching()) {
+        searchResults.remove(row);
+        endRemoveRows();
+        return;
+    }
+    loadedTitles.remove(books[row].getIsbn());
+    books.erase(books.begin() + row);
+    endRemoveRows();
+}
+
+bool BookTableModel::restoreSnapshot() {
+    const QByteArray payload = WarmStartCache::load(SNAPSHOT_NAME);
+    if (payload.isEmpty()) return false;
+
+    QDataStream in(payload);
+    qint32 count = 0;
+    in >> count;
+    const qint32 rowsToRead = std::clamp<qint32>(count, 0, PAGE_SIZE);
+    std::vector<Book> rows;
+    rows.reserve(static_cast<size_t>(rowsToRead));
+    for (qint32 i = 0; i < rowsToRead && in.status() == QDataStream::Ok; ++i) {
+        QString isbn, title, author;
+        qint32 totalCopies = 0, availableCopies = 0;
+        in >> isbn >> title >> author >> totalCopies >> availableCopies;
+        Book book(isbn, title, author, totalCopies);
+        book.setAvailableCopies(availableCopies);
+        rows.push_back(std::move(book));
+    }
+    if (in.status() != QDataStream::Ok || rows.empty()) return false;
+
+    const PageCursor last{rows.back().getTitle(), rows.back().getIsbn()};
+    ++generation;
+    searchTerm.clear();
+    resetToPage(std::move(rows), last, true);
+    reconciling = true;
+    changedWhileReconciling = false;
+
+    // Đối chiếu với database ở nền; giao diện đã có dữ liệu để hiển thị
+    const quint64 requestGeneration = generation;
+    LibraryService* service = &libraryService;
+    DatabaseManager::getInstance().executor().run([service]() {
+        return readCatalogPage(*service, PageCursor());
+    }).then(this, [this, requestGeneration](const CatalogPage& live) {
+        if (requestGeneration != generation) return; // đã chuyển sang tìm kiếm hoặc tải lại
+        reconciling = false;
+        if (changedWhileReconciling) {
+            // Trang đọc ở nền có thể chưa có thay đổi vừa nhận: đọc lại từ đầu
+            showCatalog();
+            return;
+        }
+        if (sameRows(books, live.books)) {
+            nextCursor = live.last;
+            hasMore = live.hasMore;
+            return;
+        }
+        resetToPage(live.books, live.last, live.hasMore);
+    }).onCanceled(this, [this, requestGeneration]() {
+        // Không đối chiếu được: giữ ảnh chụp đang hiển thị, không khóa việc nạp trang
+        if (requestGeneration == generation) reconciling = false;
+    });
+    return true;
+}
+
+void BookTableModel::saveSnapshot() const {
+    if (isSearching() || reconciling) return;
+
+    const qint32 count = static_cast<qint32>(std::min<size_t>(books.size(), PAGE_SIZE));
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out << count;
+    for (qint32 i = 0; i < count; ++i) {
+        const Book& book = books[i];
+        out << book.getIsbn() << book.getTitle() << book.getAuthor()
+            << qint32(book.getTotalCopies()) << qint32(book.getAvailableCopies());
+    }
+    WarmStartCache::save(SNAPSHOT_NAME, payload);
+}
+
+void BookTableModel::resetToPage(std::vector<Book> rows, const PageCursor& last, bool more) {
+    cancelFetch();
+    beginResetModel();
+    books = std::move(rows);
+    loadedTitles.clear();
+    for (const Book& book : books) {
+        loadedTitles.insert(book.getIsbn(), book.getTitle());
+    }
+    nextCursor = last;
+    hasMore = more;
+    endResetModel();
+}
@@ -0,0 +1,89 @@
+#ifndef BOOKTABLEMODEL_H
+#define BOOKTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QHash>
+#include <optional>
+#include <vector>
+#include "Models/book.h"
+#include "Services/pagination.h"
+#include "Services/snapshot.h"
+
+class LibraryService;
+
+// Model danh mục sách cho QTableView, đọc dữ liệu theo trang khi cần.
+// Không lọc: các trang keyset theo (title, isbn) được nạp dần qua canFetchMore/fetchMore
+// khi người dùng cuộn tới cuối, nên chỉ các dòng đã hiển thị mới được đọc vào bộ nhớ.
+// Trang được đọc trên luồng worker database và nối vào bảng khi có kết quả.
+// Có từ khóa: hiển thị kết quả tìm kiếm (đã giới hạn số dòng) theo từng lô do SearchController gửi về.
+class BookTableModel : public QAbstractTableModel {
+    Q_OBJECT
+public:
+    enum Column { IsbnColumn, TitleColumn, AuthorColumn, CopiesColumn, ColumnCount };
+
+    explicit BookTableModel(LibraryService& service, QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+
+    // Rỗng nếu row nằm ngoài phạm vi
+    std::optional<Book> bookAt(int row) const;
+    bool isSearching() const { return !searchTerm.isEmpty(); }
+
+    // Khởi động nhanh: hiển thị trang đầu của danh mục đã lưu ở lần chạy trước, rồi đọc trang
+    // thật trên luồng worker và thay thế nếu khác. Trả về false nếu không có ảnh chụp.
+    bool restoreSnapshot();
+    // Lưu trang đầu của danh mục (không lưu kết quả tìm kiếm)
+    void saveSnapshot() const;
+
+public slots:
+    // Trở về toàn bộ danh mục (bỏ từ khóa), đọc lại từ trang đầu
+    void showCatalog();
+    // Thay kết quả đang hiển thị (replace = true) hoặc nối thêm một lô kết quả tìm kiếm
+    void showSearchResults(const QString& term, const BookSnapshot& results, bool replace);
+    // Cập nhật đúng dòng của sách bị thay đổi, giữ nguyên thứ tự sắp xếp
+    void upsertBook(const Book& book);
+    void removeBook(const QString& isbn);
+
+private:
+    // Dòng của sách đã nạp, -1 nếu không có
+    int rowOf(const QString& isbn) const;
+    // Vị trí đầu tiên không đứng trước (title, isbn) trong thứ tự danh mục
+    int lowerBound(const QString& title, const QString& isbn) const;
+    void insertBookAt(int row, const Book& book);
+    void removeBookAt(int row);
+    // Thay các dòng đang hiển thị bằng một trang danh mục
+    void resetToPage(std::vector<Book> rows, const PageCursor& last, bool more);
+    // Nối trang vừa đọc ở nền rồi áp dụng lại các thay đổi nhận được trong lúc chờ
+    void appendPage(std::vector<Book> rows, const PageCursor& last, bool more);
+    // Bỏ lần đọc trang đang chờ (khi thay toàn bộ nội dung)
+    void cancelFetch();
+
+    LibraryService& libraryService;
+    QString searchTerm;
+    // Các trang danh mục đã nạp (khi không tìm kiếm)
+    std::vector<Book> books;
+    // Kết quả tìm kiếm giữ nguyên dạng cột như SearchController gửi về
+    BookSnapshot searchResults;
+    // ISBN -> tên sách của các dòng danh mục đã nạp, để tìm dòng bằng tìm kiếm nhị phân
+    QHash<QString, QString> loadedTitles;
+    PageCursor nextCursor;
+    bool hasMore = true;
+    // Đang hiển thị ảnh chụp và chờ đối chiếu với database; không nạp thêm trang trong lúc này
+    bool reconciling = false;
+    // Có thay đổi từng sách trong lúc đối chiếu: trang đọc ở nền có thể đã cũ
+    bool changedWhileReconciling = false;
+    // Tăng mỗi lần thay toàn bộ nội dung (danh mục/tìm kiếm); kết quả đối chiếu và trang cũ bị bỏ qua
+    quint64 generation = 0;
+    // Đang đọc trang kế tiếp trên luồng worker
+    bool fetching = false;
+    // Trạng thái cuối của các sách thay đổi trong lúc fetching (rỗng = đã xóa). Trang có thể được đọc
+    // trước hoặc sau khi thay đổi được commit, nên các thay đổi này được áp dụng lại sau khi nối trang.
+    QHash<QString, std::optional<Book>> changesWhileFetching;
+};
+
+#endif // BOOKTABLEMODEL_H
@@ -1,13 +1,13 @@
 #include "dashboardwidget.h"
 #include "Services/libraryservice.h"
 #include "Models/person.h"
+#include "Models/transaction.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QGridLayout>
 #include <QLabel>
 #include <QFrame>
-#include <QTimer>
 #include <QListWidget>
 #include <QDateTime>
 #include <QGroupBox>
@@ -16,16 +16,35 @@ DashboardWidget::DashboardWidget(LibraryService& service, QWidget *parent)
     : QWidget(parent), libraryService(service) {
     setupUI();
 
-    // --- Thiết lập Timer để tự động làm mới ---
-    refreshTimer = new QTimer(this);
-    connect(refreshTimer, &QTimer::timeout, this, &DashboardWidget::updateStatistics);
-    refreshTimer->start(30000); // Làm mới sau mỗi 30 giây
+    // Số liệu được đẩy tới khi dữ liệu thay đổi, không cần hẹn giờ làm mới
+    StatisticsProvider& provider = libraryService.getStatisticsProvider();
+    connect(&provider, &StatisticsProvider::statisticsChanged, this, &DashboardWidget::applyStatistics);
+    if (provider.hasStatistics()) {
+        applyStatistics(provider.statistics());
+    }
+    provider.requestUpdate();
+
+    // Hoạt động gần đây chỉ ghi các sự kiện nghiệp vụ, không ghi các lần cập nhật số liệu
+    connect(&libraryService, &LibraryService::transactionAdded, this, [this](const Transaction& transaction) {
+        addRecentActivity(QString("%1 mượn \"%2\".").arg(transaction.getUserId(), bookLabel(transaction)));
+    });
+    connect(&libraryService, &LibraryService::transactionUpdated, this, [this](const Transaction& transaction) {
+        if (transaction.getStatus() == TransactionStatus::Completed) {
+            addRecentActivity(QString("%1 trả \"%2\".").arg(transaction.getUserId(), bookLabel(transaction)));
+        } else if (transaction.getStatus() == TransactionStatus::Overdue) {
+            addRecentActivity(QString("\"%1\" của %2 đã quá hạn.").arg(bookLabel(transaction), transaction.getUserId()));
+        }
+    });
+    connect(&libraryService, &LibraryService::userAdded, this, [this](const QString& userId) {
+        addRecentActivity(QString("Người dùng %1 đã được thêm.").arg(userId));
+    });
+    connect(&libraryService, &LibraryService::userDeactivated, this, [this](const QString& userId) {
+        addRecentActivity(QString("Người dùng %1 đã bị vô hiệu hóa.").arg(userId));
+    });
 }
 
-void DashboardWidget::showEvent(QShowEvent *event) {
-    // Gọi hàm này mỗi khi widget được hiển thị
-    updateStatistics();
-    QWidget::showEvent(event);
+QString DashboardWidget::bookLabel(const Transaction& transaction) {
+    return transaction.getBookTitle().isEmpty() ? transaction.getBookIsbn() : transaction.getBookTitle();
 }
 
 void DashboardWidget::setupUI() {
@@ -109,24 +128,22 @@ QFrame* DashboardWidget::createStatCard(const QString& title, const QString& ico
     return card;
 }
 
-void DashboardWidget::updateStatistics() {
-    // Kiểm tra sách quá hạn trước
-    libraryService.checkOverdueBooks();
-
-    // Gọi service để lấy dữ liệu mới nhất
-    int bookCount = libraryService.getTotalBooksCount();
-    int userCount = libraryService.getTotalUsersCount();
-    int borrowedCount = libraryService.getActiveTransactionsCount();
-    int overdueCount = libraryService.getOverdueTransactionsCount(); // Thêm dòng này
+void DashboardWidget::applyStatistics(const LibraryStatistics& stats) {
+    // Sách quá hạn do OverdueMonitor tự phát hiện đúng hạn trả, không cần kiểm tra ở đây.
+    if (hasShownStats && stats == shownStats) return;
 
-    // Cập nhật giao diện
-    totalBooksLabel->setText(QString::number(bookCount));
-    totalUsersLabel->setText(QString::number(userCount));
-    borrowedBooksLabel->setText(QString::number(borrowedCount));
-    overdueBooksLabel->setText(QString::number(overdueCount)); // Cập nhật số lượng quá hạn
+    setValue(totalBooksLabel, stats.totalBooks, shownStats.totalBooks, !hasShownStats);
+    setValue(totalUsersLabel, stats.totalUsers, shownStats.totalUsers, !hasShownStats);
+    setValue(borrowedBooksLabel, stats.activeTransactions, shownStats.activeTransactions, !hasShownStats);
+    setValue(overdueBooksLabel, stats.overdueTransactions, shownStats.overdueTransactions, !hasShownStats);
+    shownStats = stats;
+    hasShownStats = true;
+}
 
-    // Thêm một mục vào hoạt động gần đây
-    addRecentActivity(QString("Bảng điều khiển đã được làm mới."));
+void DashboardWidget::setValue(QLabel* label, int value, int previous, bool force) {
+    if (force || value != previous) {
+        label->setText(QString::number(value));
+    }
 }
 
 void DashboardWidget::addRecentActivity(const QString& activity) {
@@ -2,28 +2,31 @@
 #define DASHBOARDWIDGET_H
 
 #include <QWidget>
+#include "Services/databasemanager.h"
 
 // Forward declarations
 class QLabel;
 class QFrame;
-class QTimer;
 class QListWidget;
 class LibraryService;
+class Transaction;
 
 class DashboardWidget : public QWidget {
     Q_OBJECT
 public:
     explicit DashboardWidget(LibraryService& service, QWidget *parent = nullptr);
-    // Hiển thị widget này sẽ kích hoạt làm mới dữ liệu
-    void showEvent(QShowEvent *event) override;
     void addRecentActivity(const QString& activity);
 
 public slots:
-    void updateStatistics();
+    // Nhận số liệu từ StatisticsProvider, chỉ đặt lại các nhãn có giá trị thay đổi
+    void applyStatistics(const LibraryStatistics& stats);
 
 private:
     void setupUI();
     QFrame* createStatCard(const QString& title, const QString& icon, const QString& color);
+    static void setValue(QLabel* label, int value, int previous, bool force);
+    // Tên sách của giao dịch, hoặc ISBN nếu giao dịch không kèm tên
+    static QString bookLabel(const Transaction& transaction);
 
     // --- UI Components ---
     QLabel* totalBooksLabel;
@@ -35,8 +38,9 @@ private:
     // --- Backend Service ---
     LibraryService& libraryService;
 
-    // --- Timer ---
-    QTimer* refreshTimer;
+    // Số liệu đang hiển thị
+    LibraryStatistics shownStats;
+    bool hasShownStats = false;
 };
 
 #endif // DASHBOARDWIDGET_H
@@ -27,14 +27,19 @@ void LoginWidget::onLoginAttempt() {
         return;
     }
 
-    // Sửa: Gọi hàm login mới và kiểm tra kết quả bool
-    if (libraryService.login(email, password)) {
-        statusLabel->setText("Đăng nhập thành công!");
-        emit loginSuccessful(); // Phát tín hiệu thành công
-    } else {
-        statusLabel->setText("Sai email hoặc mật khẩu.");
-        QMessageBox::critical(this, "Đăng nhập thất bại", "Email hoặc mật khẩu không chính xác.");
-    }
+    // Xác thực chạy trên luồng database, giao diện vẫn phản hồi trong lúc chờ
+    loginButton->setEnabled(false);
+    statusLabel->setText("Đang đăng nhập...");
+    libraryService.loginAsync(email, password).then(this, [this](bool success) {
+        loginButton->setEnabled(true);
+        if (success) {
+            statusLabel->setText("Đăng nhập thành công!");
+            emit loginSuccessful(); // Phát tín hiệu thành công
+        } else {
+            statusLabel->setText("Sai email hoặc mật khẩu.");
+            QMessageBox::critical(this, "Đăng nhập thất bại", "Email hoặc mật khẩu không chính xác.");
+        }
+    });
 }
 
 void LoginWidget::onRegisterAttempt() {
@@ -57,22 +62,26 @@ void LoginWidget::onRegisterAttempt() {
         return;
     }
 
-    if (libraryService.registerUser(name, email, password, userType)) {
-        QMessageBox::information(this, "Đăng ký thành công",
-                                 "Tài khoản của bạn đã được tạo thành công!\n"
-                                 "Vui lòng chuyển qua tab Đăng nhập để tiếp tục.");
-        // Xóa form và chuyển qua tab đăng nhập
-        regNameEdit->clear();
-        regEmailEdit->clear();
-        regPasswordEdit->clear();
-        regConfirmPasswordEdit->clear();
-        tabWidget->setCurrentIndex(0);
-        loginEmailEdit->setText(email);
-        loginPasswordEdit->setFocus();
-    } else {
-        QMessageBox::critical(this, "Đăng ký thất bại",
-                              "Không thể tạo tài khoản. Email có thể đã tồn tại.");
-    }
+    registerButton->setEnabled(false);
+    libraryService.registerUserAsync(name, email, password, userType).then(this, [this, email](bool success) {
+        registerButton->setEnabled(true);
+        if (success) {
+            QMessageBox::information(this, "Đăng ký thành công",
+                                     "Tài khoản của bạn đã được tạo thành công!\n"
+                                     "Vui lòng chuyển qua tab Đăng nhập để tiếp tục.");
+            // Xóa form và chuyển qua tab đăng nhập
+            regNameEdit->clear();
+            regEmailEdit->clear();
+            regPasswordEdit->clear();
+            regConfirmPasswordEdit->clear();
+            tabWidget->setCurrentIndex(0);
+            loginEmailEdit->setText(email);
+            loginPasswordEdit->setFocus();
+        } else {
+            QMessageBox::critical(this, "Đăng ký thất bại",
+                                  "Không thể tạo tài khoản. Email có thể đã tồn tại.");
+        }
+    });
 }
 
 
@@ -2,6 +2,7 @@
 #include "dashboardwidget.h"
 #include "bookCatalogwidget.h"
 #include "transactionwidget.h"
+#include "usermanagementwidget.h"
 #include "Services/libraryservice.h"
 #include "Models/person.h"
 
@@ -12,22 +13,33 @@
 #include <QStatusBar>
 #include <QMessageBox>
 #include <QApplication>
+#include <QCloseEvent>
+#include <QDebug>
 
 MainWindow::MainWindow(LibraryService& service, QWidget *parent)
     : QMainWindow(parent), libraryService(service) {
+    startupTimer.start();
     setWindowTitle("EduLibrary Manager");
     setMinimumSize(1024, 768);
 
     setupUI();
-    createPages();
     setupConnections();
 
-    // Mặc định hiển thị Dashboard khi khởi động
+    // Mặc định hiển thị Dashboard khi khởi động; các trang khác chỉ được tạo khi mở tới
     showDashboard();
+    qInfo() << "Main window constructed in" << startupTimer.elapsed() << "ms";
 }
 
 MainWindow::~MainWindow() = default;
 
+void MainWindow::closeEvent(QCloseEvent *event) {
+    libraryService.getStatisticsProvider().saveSnapshot();
+    if (bookCatalogPage) {
+        bookCatalogPage->saveSnapshot();
+    }
+    QMainWindow::closeEvent(event);
+}
+
 void MainWindow::setupUI() {
     // --- Thanh công cụ (Toolbar) ---
     auto toolBar = new QToolBar("Main Toolbar", this);
@@ -37,9 +49,11 @@ void MainWindow::setupUI() {
     dashboardButton = new QPushButton("Bảng điều khiển");
     booksButton = new QPushButton("Quản lý Sách");
     transactionsButton = new QPushButton("Giao dịch");
+    usersButton = new QPushButton("Quản lý Người dùng");
     toolBar->addWidget(dashboardButton);
     toolBar->addWidget(booksButton);
     toolBar->addWidget(transactionsButton);
+    toolBar->addWidget(usersButton);
 
     // Spacer để đẩy các mục sau sang phải
     auto spacer = new QWidget();
@@ -58,30 +72,47 @@ void MainWindow::setupUI() {
     setCentralWidget(centralStack);
 }
 
-void MainWindow::createPages() {
-    // Tạo các trang chức năng và thêm vào StackedWidget
-    dashboardPage = new DashboardWidget(libraryService, this);
-    bookCatalogPage = new BookCatalogWidget(libraryService, this);
-    transactionPage = new TransactionWidget(libraryService, this);
-    centralStack->addWidget(dashboardPage);
-    centralStack->addWidget(bookCatalogPage);
-    centralStack->addWidget(transactionPage);
+template <typename Page>
+Page* MainWindow::createPage(const char* name) {
+    QElapsedTimer timer;
+    timer.start();
+    auto page = new Page(libraryService, this);
+    centralStack->addWidget(page);
+    qInfo().noquote() << QString("%1 created in %2 ms (%3 ms after main window start)")
+                             .arg(QLatin1String(name)).arg(timer.elapsed()).arg(startupTimer.elapsed());
+    return page;
+}
+
+DashboardWidget* MainWindow::dashboard() {
+    if (!dashboardPage) dashboardPage = createPage<DashboardWidget>("DashboardWidget");
+    return dashboardPage;
+}
+
+BookCatalogWidget* MainWindow::bookCatalog() {
+    if (!bookCatalogPage) bookCatalogPage = createPage<BookCatalogWidget>("BookCatalogWidget");
+    return bookCatalogPage;
+}
+
+TransactionWidget* MainWindow::transactions() {
+    if (!transactionPage) transactionPage = createPage<TransactionWidget>("TransactionWidget");
+    return transactionPage;
+}
+
+UserManagementWidget* MainWindow::userManagement() {
+    if (!userManagementPage) userManagementPage = createPage<UserManagementWidget>("UserManagementWidget");
+    return userManagementPage;
 }
 
 void MainWindow::setupConnections() {
     connect(dashboardButton, &QPushButton::clicked, this, &MainWindow::showDashboard);
     connect(booksButton, &QPushButton::clicked, this, &MainWindow::showBookCatalog);
     connect(transactionsButton, &QPushButton::clicked, this, &MainWindow::showTransactionManagement);
+    connect(usersButton, &QPushButton::clicked, this, &MainWindow::showUserManagement);
     connect(logoutButton, &QPushButton::clicked, this, &MainWindow::logout);
 
     // --- KẾT NỐI TÍN HIỆU TỪ SERVICE ĐẾN CÁC WIDGET ---
-    connect(&libraryService, &LibraryService::dataChanged, bookCatalogPage, &BookCatalogWidget::refreshData);
-    connect(&libraryService, &LibraryService::dataChanged, transactionPage, &TransactionWidget::refreshData);
-
-    // Cũng nên kết nối với Dashboard để cập nhật số liệu
-    connect(&libraryService, &LibraryService::dataChanged,
-            dashboardPage, &DashboardWidget::updateStatistics);
-
+    // Danh mục sách và giao dịch tự kết nối với các tín hiệu thay đổi của chúng.
+    // Dashboard nhận số liệu từ StatisticsProvider của LibraryService.
 }
 
 void MainWindow::updateUserInfo() {
@@ -92,20 +123,25 @@ void MainWindow::updateUserInfo() {
 }
 
 void MainWindow::showDashboard() {
-    centralStack->setCurrentWidget(dashboardPage);
+    centralStack->setCurrentWidget(dashboard());
     statusBar()->showMessage("Hiển thị Bảng điều khiển", 3000);
 }
 
 void MainWindow::showBookCatalog() {
-    centralStack->setCurrentWidget(bookCatalogPage);
+    centralStack->setCurrentWidget(bookCatalog());
     statusBar()->showMessage("Hiển thị trang Quản lý Sách", 3000);
 }
 
 void MainWindow::showTransactionManagement() {
-    centralStack->setCurrentWidget(transactionPage);
+    centralStack->setCurrentWidget(transactions());
     statusBar()->showMessage("Hiển thị trang Quản lý Giao dịch", 3000);
 }
 
+void MainWindow::showUserManagement() {
+    centralStack->setCurrentWidget(userManagement());
+    statusBar()->showMessage("Hiển thị trang Quản lý Người dùng", 3000);
+}
+
 void MainWindow::logout() {
     // Phát tín hiệu để main.cpp có thể xử lý việc hiển thị lại cửa sổ đăng nhập
     QMessageBox::information(this, "Đăng xuất", "Bạn đã đăng xuất thành công.");
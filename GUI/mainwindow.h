@@ -2,6 +2,7 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
+#include <QElapsedTimer>
 
 // Forward declarations
 class QStackedWidget;
@@ -14,6 +15,7 @@ class Person;
 class DashboardWidget;
 class BookCatalogWidget;
 class TransactionWidget;
+class UserManagementWidget;
 
 class MainWindow : public QMainWindow {
     Q_OBJECT
@@ -23,16 +25,28 @@ public:
     explicit MainWindow(LibraryService& service, QWidget *parent = nullptr);
     ~MainWindow();
 
+protected:
+    // Lưu ảnh chụp của các trang đã mở để lần khởi động sau hiển thị ngay
+    void closeEvent(QCloseEvent *event) override;
+
 private slots:
     // Slots để chuyển đổi giữa các màn hình
     void showDashboard();
     void showBookCatalog();
     void showTransactionManagement();
+    void showUserManagement();
     void logout();
 
 private:
     void setupUI();
-    void createPages();
+    // Các trang được tạo ở lần đầu người dùng chuyển tới
+    DashboardWidget* dashboard();
+    BookCatalogWidget* bookCatalog();
+    TransactionWidget* transactions();
+    UserManagementWidget* userManagement();
+    // Tạo trang, thêm vào centralStack và ghi log thời gian khởi tạo
+    template <typename Page>
+    Page* createPage(const char* name);
     void setupConnections();
     void updateUserInfo();
 
@@ -42,12 +56,17 @@ private:
     QPushButton* dashboardButton;
     QPushButton* booksButton;
     QPushButton* transactionsButton;
+    QPushButton* usersButton;
     QPushButton* logoutButton;
 
-    // --- Pages ---
-    DashboardWidget* dashboardPage;
-    BookCatalogWidget* bookCatalogPage;
-    TransactionWidget* transactionPage;
+    // --- Pages --- (nullptr cho tới khi được mở)
+    DashboardWidget* dashboardPage = nullptr;
+    BookCatalogWidget* bookCatalogPage = nullptr;
+    TransactionWidget* transactionPage = nullptr;
+    UserManagementWidget* userManagementPage = nullptr;
+
+    // Tính từ lúc tạo cửa sổ, dùng cho log thời gian khởi động
+    QElapsedTimer startupTimer;
 
     // --- Backend Service ---
     LibraryService& libraryService;
@@ -0,0 +1,199 @@
+#include "transactiontablemodel.h"
+#include "Services/libraryservice.h"
+
+#include <QColor>
+#include <utility>
+
+namespace {
+// Số giao dịch đọc mỗi lần cuộn tới cuối bảng
+const int PAGE_SIZE = 200;
+
+// Dòng đã nạp đứng trước giao dịch trong thứ tự mới nhất trước
+bool newerThan(const TransactionSnapshot::Row& row, const Transaction& transaction) {
+    const QDateTime borrowDate = row.borrowDate();
+    if (borrowDate != transaction.getBorrowDate()) return borrowDate > transaction.getBorrowDate();
+    return row.id() > transaction.getId();
+}
+}
+
+TransactionTableModel::TransactionTableModel(LibraryService& service, QObject* parent)
+    : QAbstractTableModel(parent), libraryService(service) {
+}
+
+int TransactionTableModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : transactions.size();
+}
+
+int TransactionTableModel::columnCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant TransactionTableModel::data(const QModelIndex& index, int role) const {
+    const std::optional<TransactionSnapshot::Row> trans = transactionAt(index.row());
+    if (!trans) return QVariant();
+
+    if (role == Qt::BackgroundRole && index.column() == StatusColumn) {
+        switch (trans->status()) {
+        case TransactionStatus::Completed: return QColor("#d4edda");
+        case TransactionStatus::Overdue: return QColor("#f8d7da");
+        case TransactionStatus::Active:
+        default: return QColor("#fff3cd");
+        }
+    }
+    if (role != Qt::DisplayRole) return QVariant();
+
+    switch (index.column()) {
+    // Chuỗi chỉ được tạo cho các ô view thực sự vẽ
+    case IdColumn: return QString::number(trans->id());
+    case UserIdColumn: return trans->userId().toString();
+    case UserNameColumn: return trans->userName().toString();
+    case BookIsbnColumn: return trans->bookIsbn().toString();
+    case BookTitleColumn: return trans->bookTitle().toString();
+    case BorrowDateColumn: return trans->borrowDate().toString("dd/MM/yyyy hh:mm");
+    case StatusColumn:
+        switch (trans->status()) {
+        case TransactionStatus::Completed: return QString("Đã trả");
+        case TransactionStatus::Overdue: return QString("Quá hạn");
+        case TransactionStatus::Active:
+        default: return QString("Đang mượn");
+        }
+    default: return QVariant();
+    }
+}
+
+QVariant TransactionTableModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) return QVariant();
+
+    switch (section) {
+    case IdColumn: return QString("ID Giao dịch");
+    case UserIdColumn: return QString("ID Người dùng");
+    case UserNameColumn: return QString("Tên Người dùng");
+    case BookIsbnColumn: return QString("ISBN Sách");
+    case BookTitleColumn: return QString("Tên Sách");
+    case BorrowDateColumn: return QString("Ngày mượn");
+    case StatusColumn: return QString("Trạng thái");
+    default: return QVariant();
+    }
+}
+
+bool TransactionTableModel::canFetchMore(const QModelIndex& parent) const {
+    return !parent.isValid() && !fetching && hasMore;
+}
+
+void TransactionTableModel::fetchMore(const QModelIndex& parent) {
+    if (!canFetchMore(parent)) return;
+
+    // Truy vấn JOIN ba bảng chạy trên luồng worker, kết quả đọc thẳng vào snapshot dạng cột
+    fetching = true;
+    const quint64 requestGeneration = generation;
+    const PageCursor cursor = nextCursor;
+    const TransactionFilter filter = currentFilter;
+    LibraryService* service = &libraryService;
+    DatabaseManager::getInstance().executor().run([service, cursor, filter]() {
+        return service->getTransactionSnapshotPage(cursor, PAGE_SIZE, filter);
+    }).then(this, [this, requestGeneration](const SnapshotPage<TransactionSnapshot>& page) {
+        if (requestGeneration != generation) return; // điều kiện lọc đã đổi trong lúc chờ
+        appendPage(page.rows, page.last, page.hasMore);
+    }).onCanceled(this, [this, requestGeneration]() {
+        if (requestGeneration != generation) return;
+        fetching = false;
+        updatesWhileFetching.clear();
+    });
+}
+
+void TransactionTableModel::appendPage(const TransactionSnapshot& rows, const PageCursor& last, bool more) {
+    fetching = false;
+    hasMore = more;
+    // Các dòng của trang đều cũ hơn cursor; giao dịch chèn trong lúc chờ luôn mới hơn nên không bị trùng
+    if (!rows.isEmpty()) {
+        nextCursor = last;
+        const int first = transactions.size();
+        beginInsertRows(QModelIndex(), first, first + rows.size() - 1);
+        transactions.append(rows);
+        endInsertRows();
+    }
+
+    for (const Transaction& trans : std::exchange(updatesWhileFetching, {})) {
+        updateTransaction(trans);
+    }
+}
+
+std::optional<TransactionSnapshot::Row> TransactionTableModel::transactionAt(int row) const {
+    if (row < 0 || row >= transactions.size()) return std::nullopt;
+    return transactions[row];
+}
+
+void TransactionTableModel::setFilter(const TransactionFilter& filter) {
+    currentFilter = filter;
+    refresh();
+}
+
+void TransactionTableModel::refresh() {
+    ++generation;
+    fetching = false;
+    updatesWhileFetching.clear();
+    beginResetModel();
+    transactions = TransactionSnapshot();
+    nextCursor = PageCursor();
+    hasMore = true;
+    endResetModel();
+    // Trang đầu tiên được view yêu cầu qua fetchMore
+}
+
+int TransactionTableModel::lowerBound(const Transaction& transaction) const {
+    int first = 0;
+    int count = transactions.size();
+    while (count > 0) {
+        const int step = count / 2;
+        if (newerThan(transactions[first + step], transaction)) {
+            first += step + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    return first;
+}
+
+int TransactionTableModel::rowOf(const Transaction& transaction) const {
+    // borrow_date không đổi sau khi tạo nên giao dịch cũ vẫn ở đúng vị trí sắp xếp
+    const int row = lowerBound(transaction);
+    return row < transactions.size() && transactions[row].id() == transaction.getId() ? row : -1;
+}
+
+void TransactionTableModel::insertSorted(const Transaction& transaction) {
+    const int row = lowerBound(transaction);
+    // Cũ hơn trang cuối đã nạp (hoặc chưa nạp trang nào): sẽ được đọc cùng trang kế tiếp
+    if (row == transactions.size() && hasMore) return;
+
+    beginInsertRows(QModelIndex(), row, row);
+    transactions.insert(row, transaction);
+    endInsertRows();
+}
+
+void TransactionTableModel::addTransaction(const Transaction& transaction) {
+    if (currentFilter.matches(transaction)) {
+        insertSorted(transaction);
+    }
+}
+
+void TransactionTableModel::updateTransaction(const Transaction& transaction) {
+    if (fetching) updatesWhileFetching.push_back(transaction);
+
+    const int row = rowOf(transaction);
+    const bool matches = currentFilter.matches(transaction);
+
+    if (row >= 0 && matches) {
+        // Sau khi tạo, giao dịch chỉ còn đổi trạng thái (trả sách, quá hạn)
+        transactions.setStatus(row, transaction.getStatus());
+        emit dataChanged(index(row, 0), index(row, ColumnCount - 1));
+    } else if (row >= 0) {
+        // Không còn thỏa điều kiện lọc (ví dụ đang lọc "Đang mượn" và sách vừa được trả)
+        beginRemoveRows(QModelIndex(), row, row);
+        transactions.remove(row);
+        endRemoveRows();
+    } else if (matches) {
+        // Vừa thỏa điều kiện lọc (ví dụ vừa chuyển sang quá hạn)
+        insertSorted(transaction);
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef TRANSACTIONTABLEMODEL_H
+#define TRANSACTIONTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <optional>
+#include <vector>
+#include "Models/transaction.h"
+#include "Services/pagination.h"
+#include "Services/snapshot.h"
+#include "Services/transactionfilter.h"
+
+class LibraryService;
+
+// Model lịch sử giao dịch cho QTableView, mới nhất trước.
+// Các trang keyset theo (borrow_date, id) được nạp dần qua canFetchMore/fetchMore trên luồng worker,
+// điều kiện lọc (trạng thái, khoảng ngày) được áp dụng trong SQL.
+// Giao dịch mới hoặc đổi trạng thái chỉ thêm/cập nhật/bỏ đúng một dòng.
+// Các dòng đã nạp nằm trong một TransactionSnapshot, không có đối tượng Transaction cho từng dòng.
+class TransactionTableModel : public QAbstractTableModel {
+    Q_OBJECT
+public:
+    enum Column { IdColumn, UserIdColumn, UserNameColumn, BookIsbnColumn, BookTitleColumn,
+                  BorrowDateColumn, StatusColumn, ColumnCount };
+
+    explicit TransactionTableModel(LibraryService& service, QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+
+    // Rỗng nếu row nằm ngoài phạm vi; view chỉ hợp lệ tới lần thay đổi model kế tiếp
+    std::optional<TransactionSnapshot::Row> transactionAt(int row) const;
+    const TransactionFilter& filter() const { return currentFilter; }
+    void setFilter(const TransactionFilter& filter);
+
+public slots:
+    // Bỏ các dòng đã nạp và đọc lại từ trang mới nhất
+    void refresh();
+    void addTransaction(const Transaction& transaction);
+    void updateTransaction(const Transaction& transaction);
+
+private:
+    // Vị trí đầu tiên không đứng trước giao dịch trong thứ tự (borrow_date DESC, id DESC)
+    int lowerBound(const Transaction& transaction) const;
+    // Dòng của giao dịch đã nạp, -1 nếu không có
+    int rowOf(const Transaction& transaction) const;
+    // Chèn vào đúng vị trí nếu vị trí đó thuộc phần đã nạp
+    void insertSorted(const Transaction& transaction);
+    // Nối trang vừa đọc ở nền rồi áp dụng lại các cập nhật nhận được trong lúc chờ
+    void appendPage(const TransactionSnapshot& rows, const PageCursor& last, bool more);
+
+    LibraryService& libraryService;
+    TransactionFilter currentFilter;
+    TransactionSnapshot transactions;
+    PageCursor nextCursor;
+    bool hasMore = true;
+    // Tăng mỗi lần đổi điều kiện lọc/tải lại; trang của lần đọc cũ bị bỏ qua
+    quint64 generation = 0;
+    bool fetching = false;
+    // Trang đang đọc có thể chứa trạng thái trước khi các cập nhật này được commit
+    std::vector<Transaction> updatesWhileFetching;
+};
+
+#endif // TRANSACTIONTABLEMODEL_H
@@ -1,4 +1,5 @@
 #include "transactionwidget.h"
+#include "transactiontablemodel.h"
 #include "Services/libraryservice.h"
 #include "Models/transaction.h"
 #include "Models/person.h" // <-- THÊM INCLUDE NÀY ĐỂ SỬ DỤNG Person
@@ -6,7 +7,11 @@
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QGridLayout>
-#include <QTableWidget>
+#include <QTableView>
+#include <QComboBox>
+#include <QCheckBox>
+#include <QDateEdit>
+#include <QLabel>
 #include <QLineEdit>
 #include <QPushButton>
 #include <QGroupBox>
@@ -25,7 +30,7 @@ TransactionWidget::TransactionWidget(LibraryService& service, QWidget *parent)
 // SỬA LỖI: Thêm lại hàm showEvent để tự động cập nhật và điền thông tin
 void TransactionWidget::showEvent(QShowEvent *event) {
     QWidget::showEvent(event);
-    refreshData(); // Luôn làm mới dữ liệu khi người dùng chuyển sang tab này
+    // Không cần tải lại: model nạp trang đầu khi cần và tự nhận các thay đổi từng giao dịch
 
     // Cải thiện UX: Tự động điền ID người dùng đang đăng nhập
     Person* currentUser = libraryService.getCurrentUser();
@@ -65,16 +70,38 @@ void TransactionWidget::setupUI() {
 
     auto historyGroup = new QGroupBox("Lịch sử Giao dịch");
     auto historyLayout = new QVBoxLayout(historyGroup);
+    auto filterLayout = new QHBoxLayout();
+    statusFilterCombo = new QComboBox();
+    statusFilterCombo->addItem("Tất cả trạng thái", -1);
+    statusFilterCombo->addItem("Đang mượn", static_cast<int>(TransactionStatus::Active));
+    statusFilterCombo->addItem("Quá hạn", static_cast<int>(TransactionStatus::Overdue));
+    statusFilterCombo->addItem("Đã trả", static_cast<int>(TransactionStatus::Completed));
+    dateFilterCheck = new QCheckBox("Ngày mượn từ");
+    fromDateEdit = new QDateEdit(QDate::currentDate().addMonths(-1));
+    fromDateEdit->setCalendarPopup(true);
+    fromDateEdit->setDisplayFormat("dd/MM/yyyy");
+    toDateEdit = new QDateEdit(QDate::currentDate());
+    toDateEdit->setCalendarPopup(true);
+    toDateEdit->setDisplayFormat("dd/MM/yyyy");
+    fromDateEdit->setEnabled(false);
+    toDateEdit->setEnabled(false);
     refreshButton = new QPushButton("Làm mới danh sách");
-    historyLayout->addWidget(refreshButton, 0, Qt::AlignRight);
-
-    transactionTable = new QTableWidget();
-    transactionTable->setColumnCount(7);
-    transactionTable->setHorizontalHeaderLabels({
-        "ID Giao dịch", "ID Người dùng", "Tên Người dùng",
-        "ISBN Sách", "Tên Sách", "Ngày mượn", "Trạng thái"
-    });
+    filterLayout->addWidget(statusFilterCombo);
+    filterLayout->addWidget(dateFilterCheck);
+    filterLayout->addWidget(fromDateEdit);
+    filterLayout->addWidget(new QLabel("đến"));
+    filterLayout->addWidget(toDateEdit);
+    filterLayout->addStretch();
+    filterLayout->addWidget(refreshButton);
+    historyLayout->addLayout(filterLayout);
+
+    transactionModel = new TransactionTableModel(libraryService, this);
+    transactionTable = new QTableView();
+    transactionTable->setModel(transactionModel);
     transactionTable->horizontalHeader()->setStretchLastSection(true);
+    transactionTable->verticalHeader()->setVisible(false);
+    transactionTable->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    transactionTable->setSelectionMode(QAbstractItemView::SingleSelection);
     transactionTable->setSelectionBehavior(QAbstractItemView::SelectRows);
     transactionTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
     historyLayout->addWidget(transactionTable);
@@ -84,64 +111,48 @@ void TransactionWidget::setupUI() {
 
 void TransactionWidget::setupConnections() {
     connect(&libraryService, &LibraryService::dataChanged, this, &TransactionWidget::refreshData);
+    connect(&libraryService, &LibraryService::transactionAdded, transactionModel, &TransactionTableModel::addTransaction);
+    connect(&libraryService, &LibraryService::transactionUpdated, transactionModel, &TransactionTableModel::updateTransaction);
     connect(refreshButton, &QPushButton::clicked, this, &TransactionWidget::refreshData);
     connect(borrowButton, &QPushButton::clicked, this, &TransactionWidget::onProcessBorrow);
     connect(returnButton, &QPushButton::clicked, this, &TransactionWidget::onProcessReturn);
-    connect(transactionTable, &QTableWidget::itemSelectionChanged, this, &TransactionWidget::onTableItemSelected);
+    connect(transactionTable->selectionModel(), &QItemSelectionModel::selectionChanged, this, &TransactionWidget::onTableItemSelected);
+
+    connect(statusFilterCombo, &QComboBox::currentIndexChanged, this, &TransactionWidget::onFilterChanged);
+    connect(dateFilterCheck, &QCheckBox::toggled, this, &TransactionWidget::onFilterChanged);
+    connect(fromDateEdit, &QDateEdit::dateChanged, this, &TransactionWidget::onFilterChanged);
+    connect(toDateEdit, &QDateEdit::dateChanged, this, &TransactionWidget::onFilterChanged);
 }
 
 void TransactionWidget::refreshData() {
-    auto transactions = libraryService.getAllTransactions();
-    populateTable(transactions);
+    transactionModel->refresh();
 }
 
-void TransactionWidget::populateTable(const std::vector<std::unique_ptr<Transaction>>& transactions) {
-    transactionTable->setRowCount(0);
-    transactionTable->blockSignals(true);
-    for (const auto& trans : transactions) {
-        int row = transactionTable->rowCount();
-        transactionTable->insertRow(row);
-
-        transactionTable->setItem(row, 0, new QTableWidgetItem(QString::number(trans->getId())));
-        transactionTable->setItem(row, 1, new QTableWidgetItem(trans->getUserId()));
-        transactionTable->setItem(row, 2, new QTableWidgetItem(trans->getUserName()));
-        transactionTable->setItem(row, 3, new QTableWidgetItem(trans->getBookIsbn()));
-        transactionTable->setItem(row, 4, new QTableWidgetItem(trans->getBookTitle()));
-        transactionTable->setItem(row, 5, new QTableWidgetItem(trans->getBorrowDate().toString("dd/MM/yyyy hh:mm")));
-
-        QTableWidgetItem* statusItem = new QTableWidgetItem();
-        QString statusText;
-        QColor statusColor;
-
-        switch(trans->getStatus()) {
-        case TransactionStatus::Completed:
-            statusText = "Đã trả";
-            statusColor = QColor("#d4edda");
-            break;
-        case TransactionStatus::Overdue:
-            statusText = "Quá hạn";
-            statusColor = QColor("#f8d7da");
-            break;
-        case TransactionStatus::Active:
-        default:
-            statusText = "Đang mượn";
-            statusColor = QColor("#fff3cd");
-            break;
-        }
-        statusItem->setText(statusText);
-        statusItem->setBackground(statusColor);
-        transactionTable->setItem(row, 6, statusItem);
+void TransactionWidget::onFilterChanged() {
+    const bool byDate = dateFilterCheck->isChecked();
+    fromDateEdit->setEnabled(byDate);
+    toDateEdit->setEnabled(byDate);
+
+    TransactionFilter filter;
+    const int status = statusFilterCombo->currentData().toInt();
+    if (status >= 0) {
+        filter.status = static_cast<TransactionStatus>(status);
+    }
+    if (byDate) {
+        // Bao gồm cả ngày cuối: mốc trên là đầu ngày hôm sau
+        filter.from = fromDateEdit->date().startOfDay();
+        filter.to = toDateEdit->date().addDays(1).startOfDay();
     }
-    transactionTable->blockSignals(false);
+    transactionModel->setFilter(filter);
 }
 
 void TransactionWidget::onTableItemSelected() {
-    int currentRow = transactionTable->currentRow();
-    if (currentRow < 0) return;
+    const QModelIndexList selected = transactionTable->selectionModel()->selectedRows();
+    if (selected.isEmpty()) return;
 
-    QString status = transactionTable->item(currentRow, 6)->text();
-    if (status != "Đã trả") {
-        returnTransactionIdEdit->setText(transactionTable->item(currentRow, 0)->text());
+    const std::optional<TransactionSnapshot::Row> trans = transactionModel->transactionAt(selected.first().row());
+    if (trans && trans->status() != TransactionStatus::Completed) {
+        returnTransactionIdEdit->setText(QString::number(trans->id()));
     }
 }
 
@@ -154,13 +165,20 @@ void TransactionWidget::onProcessBorrow() {
         return;
     }
 
-    if (libraryService.borrowBook(userId, bookIsbn)) {
-        QMessageBox::information(this, "Thành công", "Mượn sách thành công!");
-        // Không cần clear userIdEdit vì nó là read-only và sẽ được cập nhật khi chuyển tab
-        borrowBookIsbnEdit->clear();
-    } else {
-        QMessageBox::critical(this, "Thất bại", "Không thể mượn sách. Vui lòng kiểm tra lại ISBN và số lượng sách có sẵn.");
-    }
+    borrowButton->setEnabled(false);
+    libraryService.borrowBookAsync(userId, bookIsbn).then(this, [this](bool success) {
+        borrowButton->setEnabled(true);
+        if (success) {
+            QMessageBox::information(this, "Thành công", "Mượn sách thành công!");
+            // Không cần clear userIdEdit vì nó là read-only và sẽ được cập nhật khi chuyển tab
+            borrowBookIsbnEdit->clear();
+        } else {
+            QMessageBox::critical(this, "Thất bại", "Không thể mượn sách. Vui lòng kiểm tra lại ISBN và số lượng sách có sẵn.");
+        }
+    }).onCanceled(this, [this]() {
+        // Executor đã dừng trước khi chạy yêu cầu: không để nút bị khóa vĩnh viễn
+        borrowButton->setEnabled(true);
+    });
 }
 
 void TransactionWidget::onProcessReturn() {
@@ -170,10 +188,16 @@ void TransactionWidget::onProcessReturn() {
         return;
     }
 
-    if (libraryService.returnBook(transactionId)) {
-        QMessageBox::information(this, "Thành công", "Trả sách thành công!");
-        returnTransactionIdEdit->clear();
-    } else {
-        QMessageBox::critical(this, "Thất bại", "Không thể trả sách. Giao dịch có thể đã được trả hoặc ID không hợp lệ.");
-    }
+    returnButton->setEnabled(false);
+    libraryService.returnBookAsync(transactionId).then(this, [this](bool success) {
+        returnButton->setEnabled(true);
+        if (success) {
+            QMessageBox::information(this, "Thành công", "Trả sách thành công!");
+            returnTransactionIdEdit->clear();
+        } else {
+            QMessageBox::critical(this, "Thất bại", "Không thể trả sách. Giao dịch có thể đã được trả hoặc ID không hợp lệ.");
+        }
+    }).onCanceled(this, [this]() {
+        returnButton->setEnabled(true);
+    });
 }
@@ -2,15 +2,16 @@
 #define TRANSACTIONWIDGET_H
 
 #include <QWidget>
-#include <memory>
-#include <vector>
 
 // Forward declarations
-class QTableWidget;
+class QTableView;
 class QLineEdit;
 class QPushButton;
+class QComboBox;
+class QCheckBox;
+class QDateEdit;
 class LibraryService;
-class Transaction;
+class TransactionTableModel;
 class QShowEvent; // Thêm forward declaration cho QShowEvent
 
 class TransactionWidget : public QWidget {
@@ -29,11 +30,11 @@ private slots:
     void onProcessBorrow();
     void onProcessReturn();
     void onTableItemSelected();
+    void onFilterChanged();
 
 private:
     void setupUI();
     void setupConnections();
-    void populateTable(const std::vector<std::unique_ptr<Transaction>>& transactions);
 
     // --- UI Components ---
     QLineEdit* borrowUserIdEdit;
@@ -41,8 +42,15 @@ private:
     QPushButton* borrowButton;
     QLineEdit* returnTransactionIdEdit;
     QPushButton* returnButton;
-    QTableWidget* transactionTable;
+    QTableView* transactionTable;
+    // Nạp giao dịch theo trang khi cuộn; giao dịch mới/đổi trạng thái chỉ cập nhật đúng dòng của nó
+    TransactionTableModel* transactionModel;
     QPushButton* refreshButton;
+    // Bộ lọc lịch sử (áp dụng trong SQL)
+    QComboBox* statusFilterCombo;
+    QCheckBox* dateFilterCheck;
+    QDateEdit* fromDateEdit;
+    QDateEdit* toDateEdit;
 
     // --- Backend Service ---
     LibraryService& libraryService;
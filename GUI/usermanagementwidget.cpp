@@ -1,6 +1,6 @@
 #include "usermanagementwidget.h"
 #include "Services/libraryservice.h"
-#include "Services/notificationservice.h"
+#include "usertablemodel.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QTableWidget>
@@ -18,10 +18,13 @@
 #include <QFileDialog>
 #include <QFormLayout>
 #include <QGridLayout>
+#include <QDesktopServices>
+#include <QUrl>
+#include <QUrlQuery>
+#include <QColor>
+#include <QBrush>
 
-UserManagementWidget::UserManagementWidget(LibraryService* libService,
-                                          NotificationService* notifService,
-                                          QWidget *parent)
+UserManagementWidget::UserManagementWidget(LibraryService& service, QWidget *parent)
     : QWidget(parent)
     , mainSplitter(nullptr)
     , rightTabWidget(nullptr)
@@ -29,10 +32,11 @@ UserManagementWidget::UserManagementWidget(LibraryService* libService,
     , userTypeFilterCombo(nullptr)
     , statusFilterCombo(nullptr)
     , userTable(nullptr)
+    , userModel(nullptr)
+    , searchDebounceTimer(nullptr)
     , userCountLabel(nullptr)
     , userFormGroup(nullptr)
-    , libraryService(libService)
-    , notificationService(notifService)
+    , libraryService(service)
     , currentUserId("")
     , isEditMode(false)
 {
@@ -132,9 +136,16 @@ void UserManagementWidget::setupUI() {
     mainSplitter->setSizes({700, 500});
 
     // Connect signals
+    searchDebounceTimer = new QTimer(this);
+    searchDebounceTimer->setSingleShot(true);
+    searchDebounceTimer->setInterval(250);
+    connect(searchDebounceTimer, &QTimer::timeout, this, &UserManagementWidget::filterUsers);
     connect(searchEdit, &QLineEdit::textChanged, this, &UserManagementWidget::onSearchTextChanged);
     connect(userTypeFilterCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &UserManagementWidget::onUserTypeChanged);
-    connect(userTable, &QTableWidget::itemSelectionChanged, this, &UserManagementWidget::onUserTableSelectionChanged);
+    connect(statusFilterCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &UserManagementWidget::filterUsers);
+    connect(userTable->selectionModel(), &QItemSelectionModel::selectionChanged,
+            this, &UserManagementWidget::onUserTableSelectionChanged);
+    connect(userModel, &UserTableModel::countsChanged, this, &UserManagementWidget::updateUserCount);
     connect(addUserBtn, &QPushButton::clicked, this, &UserManagementWidget::onAddUserClicked);
     connect(editUserBtn, &QPushButton::clicked, this, &UserManagementWidget::onEditUserClicked);
     connect(deleteUserBtn, &QPushButton::clicked, this, &UserManagementWidget::onDeleteUserClicked);
@@ -146,22 +157,21 @@ void UserManagementWidget::setupUI() {
 }
 
 void UserManagementWidget::setupUserTable() {
-    userTable = new QTableWidget();
-    userTable->setColumnCount(7);
-
-    QStringList headers = {"User ID", "Name", "Email", "Type", "Status", "Joined", "Last Active"};
-    userTable->setHorizontalHeaderLabels(headers);
+    // Dữ liệu được đọc theo trang từ bảng users, lọc và sắp xếp trong SQL
+    userModel = new UserTableModel(libraryService, this);
+    userTable = new QTableView();
+    userTable->setModel(userModel);
 
     // Table styling
     userTable->setStyleSheet(
-        "QTableWidget {"
+        "QTableView {"
         "    background-color: white;"
         "    alternate-background-color: #f8f9fa;"
         "    selection-background-color: #4a90e2;"
         "    gridline-color: #e0e0e0;"
         "    border: 1px solid #ddd;"
         "}"
-        "QTableWidget::item {"
+        "QTableView::item {"
         "    padding: 8px;"
         "    border-bottom: 1px solid #f0f0f0;"
         "}"
@@ -177,16 +187,17 @@ void UserManagementWidget::setupUserTable() {
     userTable->setAlternatingRowColors(true);
     userTable->setSelectionBehavior(QAbstractItemView::SelectRows);
     userTable->setSelectionMode(QAbstractItemView::SingleSelection);
+    // Bấm tiêu đề cột gọi UserTableModel::sort (ORDER BY trong SQL)
+    userTable->horizontalHeader()->setSortIndicator(UserTableModel::NameColumn, Qt::AscendingOrder);
     userTable->setSortingEnabled(true);
 
     // Set column widths
     userTable->horizontalHeader()->setStretchLastSection(true);
-    userTable->setColumnWidth(0, 100); // User ID
-    userTable->setColumnWidth(1, 180); // Name
-    userTable->setColumnWidth(2, 220); // Email
-    userTable->setColumnWidth(3, 100); // Type
-    userTable->setColumnWidth(4, 80);  // Status
-    userTable->setColumnWidth(5, 100); // Joined
+    userTable->setColumnWidth(UserTableModel::IdColumn, 100);
+    userTable->setColumnWidth(UserTableModel::NameColumn, 180);
+    userTable->setColumnWidth(UserTableModel::EmailColumn, 220);
+    userTable->setColumnWidth(UserTableModel::TypeColumn, 100);
+    userTable->setColumnWidth(UserTableModel::StatusColumn, 80);
 }
 
 void UserManagementWidget::setupUserForm() {
@@ -276,7 +287,7 @@ void UserManagementWidget::setupUserForm() {
 
     addUserBtn = new QPushButton("👤 Add User");
     editUserBtn = new QPushButton("✏️ Update User");
-    deleteUserBtn = new QPushButton("🗑️ Delete User");
+    deleteUserBtn = new QPushButton("🚫 Deactivate User");
     clearFormBtn = new QPushButton("🧹 Clear Form");
     viewDetailsBtn = new QPushButton("👁️ View Details");
 
@@ -383,55 +394,16 @@ void UserManagementWidget::setupUserDetailsTab() {
 }
 
 void UserManagementWidget::loadUsers() {
-    // Mock data for demonstration
-    userTable->setRowCount(0);
-
-    // Sample users
-    QStringList sampleUsers = {
-        "STU001|John Doe|john.doe@student.edu|Student|Active|2024-01-15|2024-08-25",
-        "STU002|Jane Smith|jane.smith@student.edu|Student|Active|2024-02-20|2024-08-24",
-        "FAC001|Dr. Robert Johnson|r.johnson@faculty.edu|Faculty|Active|2023-09-01|2024-08-23",
-        "FAC002|Prof. Emily Davis|e.davis@faculty.edu|Faculty|Active|2022-08-15|2024-08-22",
-        "LIB001|Admin Librarian|admin@library.edu|Librarian|Active|2022-01-01|2024-08-26",
-        "STU003|Mike Wilson|mike.w@student.edu|Student|Suspended|2024-03-10|2024-07-15",
-        "FAC003|Dr. Sarah Brown|s.brown@faculty.edu|Faculty|Inactive|2023-06-01|2024-06-30"
-    };
-
-    for (int i = 0; i < sampleUsers.size(); ++i) {
-        QStringList parts = sampleUsers[i].split('|');
-        if (parts.size() >= 7) {
-            userTable->insertRow(i);
-            for (int j = 0; j < parts.size(); ++j) {
-                QTableWidgetItem* item = new QTableWidgetItem(parts[j]);
-                if (j == 4) { // Status column
-                    if (parts[j] == "Active") {
-                        item->setBackground(QBrush(QColor(200, 255, 200)));
-                    } else if (parts[j] == "Suspended") {
-                        item->setBackground(QBrush(QColor(255, 200, 200)));
-                    } else if (parts[j] == "Inactive") {
-                        item->setBackground(QBrush(QColor(255, 255, 200)));
-                    }
-                }
-                userTable->setItem(i, j, item);
-            }
-        }
-    }
-
-    updateUserCount();
+    userModel->refresh();
 }
 
-void UserManagementWidget::updateUserCount() {
-    int totalUsers = userTable->rowCount();
-    int activeUsers = 0;
-
-    for (int i = 0; i < totalUsers; ++i) {
-        QTableWidgetItem* statusItem = userTable->item(i, 4);
-        if (statusItem && statusItem->text() == "Active") {
-            activeUsers++;
-        }
-    }
+const UserSummary* UserManagementWidget::selectedUser() const {
+    const QModelIndexList rows = userTable->selectionModel()->selectedRows();
+    return rows.isEmpty() ? nullptr : userModel->userAt(rows.first().row());
+}
 
-    userCountLabel->setText(QString("Total Users: %1 | Active: %2").arg(totalUsers).arg(activeUsers));
+void UserManagementWidget::updateUserCount(const UserCounts& counts) {
+    userCountLabel->setText(QString("Total Users: %1 | Active: %2").arg(counts.total).arg(counts.active));
 }
 
 void UserManagementWidget::showUserTypeFields() {
@@ -446,38 +418,21 @@ void UserManagementWidget::showUserTypeFields() {
 void UserManagementWidget::onAddUserClicked() {
     if (!validateUserForm()) return;
 
-    // Create new user (simplified)
-    QString name = nameEdit->text();
-    QString email = emailEdit->text();
+    QString name = nameEdit->text().trimmed();
+    QString email = emailEdit->text().trimmed();
     QString userType = userTypeCombo->currentText();
 
-    // Generate user ID
-    QString userIdPrefix = userType == "Student" ? "STU" : (userType == "Faculty" ? "FAC" : "LIB");
-    QString userId = QString("%1%2").arg(userIdPrefix).arg(QString::number(userTable->rowCount() + 1).rightJustified(3, '0'));
-
-    // Add to table
-    int row = userTable->rowCount();
-    userTable->insertRow(row);
-
-    userTable->setItem(row, 0, new QTableWidgetItem(userId));
-    userTable->setItem(row, 1, new QTableWidgetItem(name));
-    userTable->setItem(row, 2, new QTableWidgetItem(email));
-    userTable->setItem(row, 3, new QTableWidgetItem(userType));
-
-    QTableWidgetItem* statusItem = new QTableWidgetItem("Active");
-    statusItem->setBackground(QBrush(QColor(200, 255, 200)));
-    userTable->setItem(row, 4, statusItem);
-
-    userTable->setItem(row, 5, new QTableWidgetItem(QDate::currentDate().toString("yyyy-MM-dd")));
-    userTable->setItem(row, 6, new QTableWidgetItem(QDate::currentDate().toString("yyyy-MM-dd")));
-
-    QMessageBox::information(this, "Success", QString("User '%1' added successfully!").arg(name));
-
-    // Send notification
-    notificationService->sendWelcomeMessage(email, name, userType);
-
-    clearUserForm();
-    updateUserCount();
+    // ID được sinh khi lưu vào database; băm mật khẩu và ghi chạy ngoài luồng giao diện
+    libraryService.registerUserAsync(name, email, passwordEdit->text(), userType)
+        .then(this, [this, name](bool success) {
+        if (!success) {
+            QMessageBox::warning(this, "Add User Failed", QString("Could not add user '%1'. The email may already be in use.").arg(name));
+            return;
+        }
+        QMessageBox::information(this, "Success", QString("User '%1' added successfully!").arg(name));
+        clearUserForm();
+        loadUsers();
+    });
 }
 
 void UserManagementWidget::onEditUserClicked() {
@@ -486,21 +441,34 @@ void UserManagementWidget::onEditUserClicked() {
 }
 
 void UserManagementWidget::onDeleteUserClicked() {
-    int currentRow = userTable->currentRow();
-    if (currentRow >= 0) {
-        QString name = userTable->item(currentRow, 1)->text();
-
-        int ret = QMessageBox::question(this, "Confirm Delete",
-            QString("Are you sure you want to delete user '%1'?").arg(name),
-            QMessageBox::Yes | QMessageBox::No);
-
-        if (ret == QMessageBox::Yes) {
-            userTable->removeRow(currentRow);
-            QMessageBox::information(this, "Success", "User deleted successfully!");
-            clearUserForm();
-            updateUserCount();
+    const UserSummary* user = selectedUser();
+    if (!user) return;
+
+    // Sao chép trước khi hỏi: model có thể được tải lại trong lúc hộp thoại đang mở
+    const QString userId = user->id;
+    const QString name = user->name;
+
+    int ret = QMessageBox::question(this, "Confirm Deactivate",
+        QString("Are you sure you want to deactivate user '%1'? Their borrowing history is kept.").arg(name),
+        QMessageBox::Yes | QMessageBox::No);
+    if (ret != QMessageBox::Yes) return;
+
+    // Người dùng chỉ chuyển sang Inactive; lịch sử mượn vẫn giữ nguyên
+    deleteUserBtn->setEnabled(false);
+    libraryService.deactivateUserAsync(userId).then(this, [this, name](bool success) {
+        if (!success) {
+            deleteUserBtn->setEnabled(true);
+            QMessageBox::warning(this, "Deactivate Failed",
+                QString("Could not deactivate user '%1'. Users who still have books on loan, who are logged in, "
+                        "or who are already inactive cannot be deactivated.").arg(name));
+            return;
         }
-    }
+        QMessageBox::information(this, "Success", QString("User '%1' has been deactivated.").arg(name));
+        clearUserForm();
+        loadUsers();
+    }).onCanceled(this, [this]() {
+        deleteUserBtn->setEnabled(true);
+    });
 }
 
 void UserManagementWidget::onRefreshClicked() {
@@ -509,21 +477,23 @@ void UserManagementWidget::onRefreshClicked() {
 }
 
 void UserManagementWidget::onSendNotificationClicked() {
-    int currentRow = userTable->currentRow();
-    if (currentRow >= 0) {
-        QString userEmail = userTable->item(currentRow, 2)->text();
-        QString userName = userTable->item(currentRow, 1)->text();
+    if (const UserSummary* user = selectedUser()) {
+        QString userEmail = user->email;
+        QString userName = user->name;
 
         bool ok;
         QString message = QInputDialog::getMultiLineText(this, "Send Notification",
             QString("Send notification to %1:").arg(userName), "", &ok);
 
         if (ok && !message.isEmpty()) {
-            if (notificationService->sendSimpleNotification(userEmail, message)) {
-                QMessageBox::information(this, "Notification Sent",
-                                         QString("Notification sent successfully to %1").arg(userName));
-            } else {
-                QMessageBox::warning(this, "Send Failed", "Failed to send notification!");
+            // Soạn thư trong ứng dụng email mặc định của hệ thống
+            QUrl mailUrl(QString("mailto:%1").arg(userEmail));
+            QUrlQuery query;
+            query.addQueryItem("subject", "EduLibrary notification");
+            query.addQueryItem("body", message);
+            mailUrl.setQuery(query);
+            if (!QDesktopServices::openUrl(mailUrl)) {
+                QMessageBox::warning(this, "Send Failed", "Could not open the email client!");
             }
         }
     } else {
@@ -539,17 +509,9 @@ void UserManagementWidget::onExportUsersClicked() {
 }
 
 void UserManagementWidget::onViewUserDetailsClicked() {
-    int currentRow = userTable->currentRow();
-    if (currentRow >= 0) {
+    if (const UserSummary* user = selectedUser()) {
         rightTabWidget->setCurrentIndex(1); // Switch to details tab
 
-        QString userId = userTable->item(currentRow, 0)->text();
-        QString name = userTable->item(currentRow, 1)->text();
-        QString email = userTable->item(currentRow, 2)->text();
-        QString userType = userTable->item(currentRow, 3)->text();
-        QString status = userTable->item(currentRow, 4)->text();
-        QString joinDate = userTable->item(currentRow, 5)->text();
-
         // Update user info display
         detailsUserInfo->setText(
             QString("<b>%1</b><br>"
@@ -557,44 +519,70 @@ void UserManagementWidget::onViewUserDetailsClicked() {
                     "🆔 User ID: %3<br>"
                     "👤 Type: %4<br>"
                     "📊 Status: %5<br>"
-                    "📅 Joined: %6")
-                .arg(name, email, userId, userType, status, joinDate)
-            );
-
-        // Update statistics
-        userStatsLabel->setText(
-            "📚 Books Borrowed: 12 | 📖 Currently Reading: 3 | ⚠️ Overdue: 0 | 💰 Total Fines: $0.00"
+                    "📚 Active loans: %6")
+                .arg(user->name, user->email, user->id, user->userType, user->status)
+                .arg(user->activeLoans)
             );
 
-        // Load mock borrow history
+        // Lịch sử mượn được đọc trên luồng worker
+        const QString userId = user->id;
+        detailsUserId = userId;
+        userStatsLabel->setText("Loading borrowing history...");
         userBorrowHistoryTable->setRowCount(0);
-        QStringList mockHistory = {
-            "Clean Code|2024-08-01|2024-08-15|2024-08-14|Returned",
-            "Design Patterns|2024-08-10|2024-08-24||Active",
-            "Python Basics|2024-07-20|2024-08-03|2024-08-05|Returned Late",
-            "JavaScript Guide|2024-08-20|2024-09-03||Active"
-        };
-
-        for (int i = 0; i < mockHistory.size(); ++i) {
-            QStringList parts = mockHistory[i].split('|');
-            userBorrowHistoryTable->insertRow(i);
-            for (int j = 0; j < parts.size(); ++j) {
-                QTableWidgetItem* item = new QTableWidgetItem(parts[j]);
-                if (j == 4) { // Status column
-                    if (parts[j] == "Active") {
-                        item->setBackground(QBrush(QColor(200, 255, 200)));
-                    } else if (parts[j] == "Returned Late") {
-                        item->setBackground(QBrush(QColor(255, 200, 200)));
-                    }
-                }
-                userBorrowHistoryTable->setItem(i, j, item);
-            }
+        libraryService.getUserTransactionsAsync(userId).then(this, [this, userId](const std::vector<Transaction>& history) {
+            if (userId != detailsUserId) return;
+            showBorrowHistory(history);
+        });
+    } else {
+        QMessageBox::warning(this, "No Selection", "Please select a user first!");
+    }
+}
+
+void UserManagementWidget::showBorrowHistory(const std::vector<Transaction>& history) {
+    int onLoan = 0;
+    int overdue = 0;
+    userBorrowHistoryTable->setRowCount(static_cast<int>(history.size()));
+    for (int row = 0; row < static_cast<int>(history.size()); ++row) {
+        const Transaction& trans = history[row];
+        QString status;
+        QColor statusColor;
+        switch (trans.getStatus()) {
+        case TransactionStatus::Completed:
+            status = "Returned";
+            break;
+        case TransactionStatus::Overdue:
+            ++onLoan;
+            ++overdue;
+            status = "Overdue";
+            statusColor = QColor(255, 200, 200);
+            break;
+        case TransactionStatus::Active:
+        default:
+            ++onLoan;
+            status = "Active";
+            statusColor = QColor(200, 255, 200);
+            break;
+        }
+
+        const QStringList cells = {trans.getBookTitle().isEmpty() ? trans.getBookIsbn() : trans.getBookTitle(),
+                                   trans.getBorrowDate().toString("yyyy-MM-dd"),
+                                   trans.getDueDate().toString("yyyy-MM-dd"),
+                                   trans.getReturnDate().toString("yyyy-MM-dd"),
+                                   status};
+        for (int column = 0; column < cells.size(); ++column) {
+            userBorrowHistoryTable->setItem(row, column, new QTableWidgetItem(cells[column]));
+        }
+        if (statusColor.isValid()) {
+            userBorrowHistoryTable->item(row, 4)->setBackground(QBrush(statusColor));
         }
     }
+
+    userStatsLabel->setText(QString("📚 Books Borrowed: %1 | 📖 On Loan: %2 | ⚠️ Overdue: %3")
+                                .arg(static_cast<int>(history.size())).arg(onLoan).arg(overdue));
 }
 
 void UserManagementWidget::onSearchTextChanged() {
-    filterUsers();
+    searchDebounceTimer->start();
 }
 
 void UserManagementWidget::onUserTypeChanged() {
@@ -602,13 +590,12 @@ void UserManagementWidget::onUserTypeChanged() {
 }
 
 void UserManagementWidget::onUserTableSelectionChanged() {
-    int currentRow = userTable->currentRow();
-    if (currentRow >= 0) {
+    if (const UserSummary* user = selectedUser()) {
         // Populate form with selected user data
-        userIdEdit->setText(userTable->item(currentRow, 0)->text());
-        nameEdit->setText(userTable->item(currentRow, 1)->text());
-        emailEdit->setText(userTable->item(currentRow, 2)->text());
-        userTypeCombo->setCurrentText(userTable->item(currentRow, 3)->text());
+        userIdEdit->setText(user->id);
+        nameEdit->setText(user->name);
+        emailEdit->setText(user->email);
+        userTypeCombo->setCurrentText(user->userType);
 
         // Switch to edit mode
         isEditMode = true;
@@ -679,33 +666,16 @@ bool UserManagementWidget::validateUserForm() {
 }
 
 void UserManagementWidget::filterUsers() {
-    QString searchText = searchEdit->text().toLower();
-    QString typeFilter = userTypeFilterCombo->currentText();
-
-    for (int i = 0; i < userTable->rowCount(); ++i) {
-        bool shouldShow = true;
-
-        // Search filter
-        if (!searchText.isEmpty()) {
-            bool matchFound = false;
-            for (int j = 0; j < 3; ++j) { // Search in ID, Name, Email columns
-                QTableWidgetItem* item = userTable->item(i, j);
-                if (item && item->text().toLower().contains(searchText)) {
-                    matchFound = true;
-                    break;
-                }
-            }
-            if (!matchFound) shouldShow = false;
-        }
+    searchDebounceTimer->stop();
 
-        // Type filter
-        if (typeFilter != "All Types" && shouldShow) {
-            QTableWidgetItem* typeItem = userTable->item(i, 3);
-            if (!typeItem || typeItem->text() != typeFilter) {
-                shouldShow = false;
-            }
-        }
-
-        userTable->setRowHidden(i, !shouldShow);
+    // Mục đầu tiên của mỗi combo ("All ...") nghĩa là không lọc
+    UserFilter filter;
+    filter.text = searchEdit->text().trimmed();
+    if (userTypeFilterCombo->currentIndex() > 0) {
+        filter.userType = userTypeFilterCombo->currentText();
+    }
+    if (statusFilterCombo->currentIndex() > 0) {
+        filter.status = statusFilterCombo->currentText();
     }
+    userModel->setFilter(filter);
 }
@@ -5,6 +5,8 @@
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QTableWidget>
+#include <QTableView>
+#include <QTimer>
 #include <QLineEdit>
 #include <QPushButton>
 #include <QComboBox>
@@ -13,16 +15,20 @@
 #include <QDateEdit>
 #include <QSplitter>
 #include <QTabWidget>
+#include <vector>
+
+#include "Models/transaction.h"
+#include "Services/userdirectory.h"
 
 class LibraryService;
-class NotificationService;
 class Person;
+class UserTableModel;
 
 class UserManagementWidget : public QWidget {
+    Q_OBJECT
+
 public:
-    explicit UserManagementWidget(LibraryService* libService,
-                                  NotificationService* notifService,
-                                  QWidget *parent = nullptr);
+    explicit UserManagementWidget(LibraryService& service, QWidget *parent = nullptr);
 
 private slots:
     void onAddUserClicked();
@@ -41,11 +47,13 @@ private:
     void setupUserTable();
     void setupUserForm();
     void loadUsers();
+    const UserSummary* selectedUser() const;
     void clearUserForm();
     void populateUserForm(const Person* user);
     bool validateUserForm();
     void filterUsers();
-    void updateUserCount();
+    void updateUserCount(const UserCounts& counts);
+    void showBorrowHistory(const std::vector<Transaction>& history);
     void showUserDetails(int userId);
 
     // ✅ ADD MISSING METHODS
@@ -61,7 +69,10 @@ private:
     QLineEdit* searchEdit;
     QComboBox* userTypeFilterCombo;
     QComboBox* statusFilterCombo;
-    QTableWidget* userTable;
+    QTableView* userTable;
+    UserTableModel* userModel;
+    // Gộp các lần gõ phím liên tiếp thành một lần lọc
+    QTimer* searchDebounceTimer;
     QLabel* userCountLabel;
 
     // Right side - User form tab
@@ -110,10 +121,11 @@ private:
     QLabel* detailsUserInfo;
     QTableWidget* userBorrowHistoryTable;
     QLabel* userStatsLabel;
+    // Người dùng đang hiển thị ở tab chi tiết; lịch sử đọc xong cho người khác bị bỏ qua
+    QString detailsUserId;
 
     // Services
-    LibraryService* libraryService;
-    NotificationService* notificationService;
+    LibraryService& libraryService;
 
     // Current selected user
     QString currentUserId;
@@ -0,0 +1,135 @@
+#include "usertablemodel.h"
+#include "Services/libraryservice.h"
+
+#include <QColor>
+
+namespace {
+// Số người dùng đọc mỗi lần cuộn tới cuối bảng
+const int PAGE_SIZE = 200;
+}
+
+UserTableModel::UserTableModel(LibraryService& service, QObject* parent)
+    : QAbstractTableModel(parent), libraryService(service) {
+}
+
+int UserTableModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : static_cast<int>(users.size());
+}
+
+int UserTableModel::columnCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant UserTableModel::data(const QModelIndex& index, int role) const {
+    const UserSummary* user = userAt(index.row());
+    if (!user) return QVariant();
+
+    if (role == Qt::BackgroundRole && index.column() == StatusColumn) {
+        if (user->status == QLatin1String("Suspended")) return QColor(255, 200, 200);
+        if (user->status == QLatin1String("Inactive")) return QColor(255, 255, 200);
+        return QColor(200, 255, 200);
+    }
+    if (role != Qt::DisplayRole) return QVariant();
+
+    switch (index.column()) {
+    case IdColumn: return user->id;
+    case NameColumn: return user->name;
+    case EmailColumn: return user->email;
+    case TypeColumn: return user->userType;
+    case StatusColumn: return user->status;
+    case ActiveLoansColumn: return user->activeLoans;
+    default: return QVariant();
+    }
+}
+
+QVariant UserTableModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) return QVariant();
+
+    switch (section) {
+    case IdColumn: return QString("User ID");
+    case NameColumn: return QString("Name");
+    case EmailColumn: return QString("Email");
+    case TypeColumn: return QString("Type");
+    case StatusColumn: return QString("Status");
+    case ActiveLoansColumn: return QString("Active Loans");
+    default: return QVariant();
+    }
+}
+
+bool UserTableModel::canFetchMore(const QModelIndex& parent) const {
+    return !parent.isValid() && !loading && hasMore;
+}
+
+void UserTableModel::fetchMore(const QModelIndex& parent) {
+    if (!canFetchMore(parent)) return;
+
+    // Trang tiếp theo cũng được đọc trên luồng worker như trang đầu
+    const quint64 requestGeneration = generation;
+    loading = true;
+    libraryService.getUsersAsync(currentFilter, PAGE_SIZE, nextCursor).then(this, [this, requestGeneration](const UserListing& listing) {
+        if (requestGeneration != generation) return; // điều kiện lọc đã đổi trong lúc chờ
+        appendPage(listing);
+    }).onCanceled(this, [this, requestGeneration]() {
+        if (requestGeneration == generation) loading = false;
+    });
+}
+
+void UserTableModel::appendPage(const UserListing& listing) {
+    loading = false;
+    hasMore = listing.hasMore;
+    if (listing.users.empty()) return;
+    nextCursor = listing.last;
+
+    const int first = static_cast<int>(users.size());
+    beginInsertRows(QModelIndex(), first, first + static_cast<int>(listing.users.size()) - 1);
+    users.insert(users.end(), listing.users.begin(), listing.users.end());
+    endInsertRows();
+}
+
+void UserTableModel::sort(int column, Qt::SortOrder order) {
+    UserFilter filter = currentFilter;
+    switch (column) {
+    case IdColumn: filter.sortColumn = UserSortColumn::Id; break;
+    case NameColumn: filter.sortColumn = UserSortColumn::Name; break;
+    case EmailColumn: filter.sortColumn = UserSortColumn::Email; break;
+    default: return;
+    }
+    filter.sortOrder = order;
+    if (filter.sortColumn == currentFilter.sortColumn && filter.sortOrder == currentFilter.sortOrder) return;
+
+    currentFilter = filter;
+    refresh();
+}
+
+const UserSummary* UserTableModel::userAt(int row) const {
+    return row >= 0 && row < static_cast<int>(users.size()) ? &users[row] : nullptr;
+}
+
+void UserTableModel::setFilter(const UserFilter& filter) {
+    const UserSortColumn sortColumn = currentFilter.sortColumn;
+    const Qt::SortOrder sortOrder = currentFilter.sortOrder;
+    currentFilter = filter;
+    currentFilter.sortColumn = sortColumn;
+    currentFilter.sortOrder = sortOrder;
+    refresh();
+}
+
+void UserTableModel::refresh() {
+    const quint64 requestGeneration = ++generation;
+    loading = true;
+
+    libraryService.getUsersAsync(currentFilter, PAGE_SIZE).then(this, [this, requestGeneration](const UserListing& listing) {
+        if (requestGeneration != generation) return;
+
+        beginResetModel();
+        users = listing.users;
+        nextCursor = listing.last;
+        hasMore = listing.hasMore;
+        loading = false;
+        endResetModel();
+        emit countsChanged(listing.counts);
+    }).onCanceled(this, [this, requestGeneration]() {
+        // Executor đã dừng: không để canFetchMore bị khóa mãi
+        if (requestGeneration == generation) loading = false;
+    });
+}
@@ -0,0 +1,57 @@
+#ifndef USERTABLEMODEL_H
+#define USERTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <vector>
+#include "Services/pagination.h"
+#include "Services/userdirectory.h"
+
+class LibraryService;
+
+// Model danh sách người dùng cho QTableView.
+// Lọc (loại, trạng thái, từ khóa) và sắp xếp được thực hiện trong SQL; khi đổi điều kiện,
+// trang đầu tiên và số đếm được đọc trên luồng worker database, các trang sau được nạp
+// dần qua canFetchMore/fetchMore, cũng trên luồng worker. Kết quả của điều kiện lọc cũ bị bỏ qua.
+class UserTableModel : public QAbstractTableModel {
+    Q_OBJECT
+public:
+    enum Column { IdColumn, NameColumn, EmailColumn, TypeColumn, StatusColumn, ActiveLoansColumn, ColumnCount };
+
+    explicit UserTableModel(LibraryService& service, QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+    // Chỉ các cột có index (ID, tên, email) được sắp xếp; cột khác giữ nguyên thứ tự hiện tại
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+    // nullptr nếu row nằm ngoài phạm vi
+    const UserSummary* userAt(int row) const;
+    const UserFilter& filter() const { return currentFilter; }
+    // Giữ nguyên cột sắp xếp hiện tại
+    void setFilter(const UserFilter& filter);
+
+public slots:
+    // Đọc lại từ trang đầu với điều kiện hiện tại
+    void refresh();
+
+signals:
+    void countsChanged(const UserCounts& counts);
+
+private:
+    void appendPage(const UserListing& listing);
+
+    LibraryService& libraryService;
+    UserFilter currentFilter;
+    std::vector<UserSummary> users;
+    PageCursor nextCursor;
+    bool hasMore = false;
+    // Tăng mỗi lần đổi điều kiện; chỉ nhận kết quả của lần đọc mới nhất
+    quint64 generation = 0;
+    bool loading = false;
+};
+
+#endif // USERTABLEMODEL_H
@@ -1,4 +1,4 @@
-QT       += core gui sql widgets
+QT       += core gui sql widgets concurrent
 
 CONFIG += c++17 # Sử dụng C++17 để hỗ trợ tốt hơn cho smart pointers
 TARGET = EduLibraryManager
@@ -16,6 +16,10 @@ SOURCES += \
     gui/BookCatalogWidget.cpp \
     gui/DashboardWidget.cpp \
     gui/TransactionWidget.cpp \
+    gui/BookTableModel.cpp \
+    gui/TransactionTableModel.cpp \
+    gui/UserTableModel.cpp \
+    gui/UserManagementWidget.cpp \
     # Models
     models/Person.cpp \
     models/Student.cpp \
@@ -26,6 +30,21 @@ SOURCES += \
     # Services
     services/DatabaseManager.cpp \
     services/LibraryService.cpp \
+    services/ConnectionPool.cpp \
+    services/SchemaMigrator.cpp \
+    services/TransactionScope.cpp \
+    services/CsvReader.cpp \
+    services/CatalogImporter.cpp \
+    services/DatabaseExecutor.cpp \
+    services/CatalogCache.cpp \
+    services/TextNormalizer.cpp \
+    services/OverdueMonitor.cpp \
+    services/Snapshot.cpp \
+    services/PasswordHasher.cpp \
+    services/EntityCache.cpp \
+    services/SearchController.cpp \
+    services/StatisticsProvider.cpp \
+    services/WarmStartCache.cpp \
     # Factories
     factories/UserFactory.cpp
 
@@ -37,6 +56,10 @@ HEADERS += \
     gui/MainWindow.h \
     gui/DashboardWidget.h \
     gui/TransactionWidget.h \
+    gui/BookTableModel.h \
+    gui/TransactionTableModel.h \
+    gui/UserTableModel.h \
+    gui/UserManagementWidget.h \
     # Models
     models/Person.h \
     models/Student.h \
@@ -47,6 +70,26 @@ HEADERS += \
     # Services
     services/DatabaseManager.h \
     services/LibraryService.h \
+    services/LruCache.h \
+    services/ConnectionPool.h \
+    services/SchemaMigrator.h \
+    services/TransactionScope.h \
+    services/CsvReader.h \
+    services/CatalogImporter.h \
+    services/RowMapper.h \
+    services/Pagination.h \
+    services/DatabaseExecutor.h \
+    services/CatalogCache.h \
+    services/TextNormalizer.h \
+    services/OverdueMonitor.h \
+    services/Snapshot.h \
+    services/PasswordHasher.h \
+    services/EntityCache.h \
+    services/SearchController.h \
+    services/StatisticsProvider.h \
+    services/WarmStartCache.h \
+    services/TransactionFilter.h \
+    services/UserDirectory.h \
     # Factories
     factories/UserFactory.h
 
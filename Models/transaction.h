@@ -36,6 +36,8 @@ public:
     // Setters
     void setStatus(TransactionStatus newStatus) { status = newStatus; }
     void setBorrowDate(const QDateTime& date) { borrowDate = date; }
+    void setDueDate(const QDateTime& date) { dueDate = date; }
+    void setReturnDate(const QDateTime& date) { returnDate = date; }
     // --- Setters cho dữ liệu JOIN ---
     void setUserName(const QString& name) { userName = name; }
     void setBookTitle(const QString& title) { bookTitle = title; }
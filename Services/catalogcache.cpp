@@ -0,0 +1,114 @@
+#include "catalogcache.h"
+#include <QDebug>
+
+bool CatalogCache::isLoaded() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return loaded;
+}
+
+quint64 CatalogCache::generation() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return writeGeneration;
+}
+
+bool CatalogCache::load(const std::vector<std::unique_ptr<Book>>& books, quint64 expectedGeneration) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (expectedGeneration != writeGeneration) return false;
+
+    byIsbn.clear();
+    byTitle.clear();
+    byIsbn.reserve(static_cast<int>(books.size()));
+    for (const auto& book : books) {
+        insertLocked(*book);
+    }
+    loaded = true;
+    return true;
+}
+
+void CatalogCache::invalidate() {
+    std::lock_guard<std::mutex> lock(mtx);
+    ++writeGeneration;
+    byIsbn.clear();
+    byTitle.clear();
+    loaded = false;
+}
+
+void CatalogCache::upsert(const Book& book) {
+    std::lock_guard<std::mutex> lock(mtx);
+    ++writeGeneration;
+    if (!loaded) return; // Sẽ được đọc đầy đủ khi nạp cache
+    removeLocked(book.getIsbn());
+    insertLocked(book);
+}
+
+void CatalogCache::remove(const QString& isbn) {
+    std::lock_guard<std::mutex> lock(mtx);
+    ++writeGeneration;
+    removeLocked(isbn);
+}
+
+bool CatalogCache::setAvailableCopies(const QString& isbn, int availableCopies) {
+    std::lock_guard<std::mutex> lock(mtx);
+    ++writeGeneration;
+    auto it = byIsbn.find(isbn);
+    if (it == byIsbn.end()) return false;
+    it->setAvailableCopies(availableCopies);
+    return true;
+}
+
+std::vector<std::unique_ptr<Book>> CatalogCache::books() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    std::vector<std::unique_ptr<Book>> result;
+    result.reserve(byTitle.size());
+    for (const auto& key : byTitle) {
+        result.push_back(std::make_unique<Book>(byIsbn.value(key.second)));
+    }
+    return result;
+}
+
+std::unique_ptr<Book> CatalogCache::find(const QString& isbn) const {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = byIsbn.constFind(isbn);
+    return it == byIsbn.constEnd() ? nullptr : std::make_unique<Book>(*it);
+}
+
+int CatalogCache::size() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return byIsbn.size();
+}
+
+bool CatalogCache::matches(const std::vector<std::unique_ptr<Book>>& databaseBooks) const {
+    std::lock_guard<std::mutex> lock(mtx);
+    bool consistent = true;
+
+    if (static_cast<int>(databaseBooks.size()) != byIsbn.size()) {
+        qWarning() << "Catalog cache holds" << byIsbn.size() << "books, database has" << databaseBooks.size();
+        consistent = false;
+    }
+
+    for (const auto& book : databaseBooks) {
+        auto it = byIsbn.constFind(book->getIsbn());
+        if (it == byIsbn.constEnd()) {
+            qWarning() << "Catalog cache is missing ISBN" << book->getIsbn();
+            consistent = false;
+        } else if (it->getTitle() != book->getTitle() || it->getAuthor() != book->getAuthor() ||
+                   it->getTotalCopies() != book->getTotalCopies() ||
+                   it->getAvailableCopies() != book->getAvailableCopies()) {
+            qWarning() << "Catalog cache entry differs from database for ISBN" << book->getIsbn();
+            consistent = false;
+        }
+    }
+    return consistent;
+}
+
+void CatalogCache::insertLocked(const Book& book) {
+    byIsbn.insert(book.getIsbn(), book);
+    byTitle.emplace(book.getTitle(), book.getIsbn());
+}
+
+void CatalogCache::removeLocked(const QString& isbn) {
+    auto it = byIsbn.find(isbn);
+    if (it == byIsbn.end()) return;
+    byTitle.erase({it->getTitle(), isbn});
+    byIsbn.erase(it);
+}
@@ -0,0 +1,62 @@
+#ifndef CATALOGCACHE_H
+#define CATALOGCACHE_H
+
+#include <QHash>
+#include <QString>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <utility>
+#include <vector>
+#include "Models/book.h"
+
+// Bản sao đầy đủ của bảng books trong bộ nhớ, tra theo ISBN và duyệt theo thứ tự
+// (title, isbn) giống ORDER BY title của database.
+// Cache chỉ được cập nhật sau khi thao tác ghi tương ứng đã commit thành công (write-through).
+// Các hàm đều khóa mutex vì thao tác ghi có thể chạy trên luồng worker database.
+class CatalogCache {
+public:
+    CatalogCache() = default;
+
+    CatalogCache(const CatalogCache&) = delete;
+    CatalogCache& operator=(const CatalogCache&) = delete;
+
+    bool isLoaded() const;
+    // Tăng sau mỗi lần ghi vào cache (kể cả khi chưa nạp)
+    quint64 generation() const;
+    // Thay toàn bộ nội dung cache bằng danh sách sách đọc từ database.
+    // Bị từ chối (trả về false) nếu đã có thao tác ghi xen giữa lúc đọc generation và lúc nạp,
+    // vì khi đó danh sách có thể đã cũ.
+    bool load(const std::vector<std::unique_ptr<Book>>& books, quint64 expectedGeneration);
+    // Bỏ toàn bộ nội dung, lần đọc tiếp theo sẽ nạp lại từ database
+    void invalidate();
+
+    // Thêm mới hoặc thay thế sách có cùng ISBN
+    void upsert(const Book& book);
+    void remove(const QString& isbn);
+    // Ghi số bản có sẵn đã commit (giá trị tuyệt đối, không phải delta: một lần nạp lại xen giữa
+    // có thể đã chứa thay đổi này); trả về false nếu ISBN không có trong cache
+    bool setAvailableCopies(const QString& isbn, int availableCopies);
+
+    // Bản sao các sách theo thứ tự (title, isbn)
+    std::vector<std::unique_ptr<Book>> books() const;
+    std::unique_ptr<Book> find(const QString& isbn) const;
+    int size() const;
+
+    // So sánh với danh sách sách đọc từ database (đã sắp theo title); ghi log các khác biệt
+    bool matches(const std::vector<std::unique_ptr<Book>>& databaseBooks) const;
+
+private:
+    using OrderKey = std::pair<QString, QString>; // (title, isbn)
+
+    void insertLocked(const Book& book);
+    void removeLocked(const QString& isbn);
+
+    mutable std::mutex mtx;
+    bool loaded = false;
+    quint64 writeGeneration = 0;
+    QHash<QString, Book> byIsbn;
+    std::set<OrderKey> byTitle;
+};
+
+#endif // CATALOGCACHE_H
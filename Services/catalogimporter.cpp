@@ -0,0 +1,126 @@
+#include "catalogimporter.h"
+#include "csvreader.h"
+#include "databasemanager.h"
+#include "transactionscope.h"
+#include "Models/book.h"
+#include <QFile>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+// 100 dòng x 7 tham số = 700 biến, dưới giới hạn 999 của các bản SQLite cũ
+const int BATCH_SIZE = 100;
+// Báo tiến độ sau mỗi số bản ghi này
+const qint64 PROGRESS_INTERVAL = 10000;
+}
+
+CatalogImporter::CatalogImporter(QObject* parent)
+    : QObject(parent), db(DatabaseManager::getInstance()) {
+}
+
+ImportResult CatalogImporter::importFile(const QString& filePath) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Could not open catalog file" << filePath << ":" << file.errorString();
+        return ImportResult();
+    }
+    return importFrom(file);
+}
+
+ImportResult CatalogImporter::importFrom(QIODevice& device) {
+    QElapsedTimer timer;
+    timer.start();
+
+    ImportResult result;
+    TransactionScope scope(db);
+    if (!scope.isActive()) return result;
+
+    CsvReader reader(&device);
+    ColumnMap columns;
+    QStringList fields;
+    std::vector<Book> batch;
+    batch.reserve(BATCH_SIZE);
+    bool firstRecord = true;
+
+    while (reader.readRecord(fields)) {
+        // Bỏ qua dòng trống
+        if (fields.size() == 1 && fields.first().trimmed().isEmpty()) continue;
+
+        if (firstRecord) {
+            firstRecord = false;
+            if (isHeader(fields)) {
+                columns = mapHeader(fields);
+                continue;
+            }
+        }
+
+        ++result.rowsRead;
+        if (!parseRecord(fields, columns, batch)) {
+            ++result.malformed;
+            qWarning() << "Skipping malformed CSV record ending at line" << reader.lineNumber() << ":" << fields;
+        }
+
+        if (static_cast<int>(batch.size()) == BATCH_SIZE && !flush(batch, result)) {
+            return ImportResult();
+        }
+        if (result.rowsRead % PROGRESS_INTERVAL == 0) {
+            emit progress(result.rowsRead, result.rowsRead * 1000.0 / qMax<qint64>(1, timer.elapsed()));
+        }
+    }
+
+    if (!flush(batch, result) || !scope.commit()) {
+        qWarning() << "Catalog import failed, all changes were rolled back.";
+        return ImportResult();
+    }
+
+    result.ok = true;
+    result.elapsedMs = timer.elapsed();
+    emit progress(result.rowsRead, result.rowsPerSecond());
+    qInfo() << "Catalog import finished:" << result.rowsRead << "rows," << result.inserted << "inserted,"
+            << result.duplicates << "duplicates," << result.malformed << "malformed in"
+            << result.elapsedMs << "ms (" << qRound(result.rowsPerSecond()) << "rows/sec)";
+    return result;
+}
+
+bool CatalogImporter::isHeader(const QStringList& fields) {
+    return fields.first().trimmed().compare("isbn", Qt::CaseInsensitive) == 0;
+}
+
+CatalogImporter::ColumnMap CatalogImporter::mapHeader(const QStringList& fields) {
+    ColumnMap columns;
+    for (int i = 0; i < fields.size(); ++i) {
+        const QString name = fields.at(i).trimmed().toLower().remove('_').remove(' ');
+        if (name == "isbn") columns.isbn = i;
+        else if (name == "title") columns.title = i;
+        else if (name == "author") columns.author = i;
+        else if (name == "totalcopies" || name == "copies") columns.totalCopies = i;
+    }
+    return columns;
+}
+
+bool CatalogImporter::parseRecord(const QStringList& fields, const ColumnMap& columns, std::vector<Book>& batch) {
+    const int lastColumn = std::max({columns.isbn, columns.title, columns.author, columns.totalCopies});
+    if (fields.size() <= lastColumn) return false;
+
+    const QString isbn = fields.at(columns.isbn).trimmed();
+    const QString title = fields.at(columns.title).trimmed();
+    bool copiesOk = false;
+    const int copies = fields.at(columns.totalCopies).trimmed().toInt(&copiesOk);
+    if (isbn.isEmpty() || title.isEmpty() || !copiesOk || copies < 0) return false;
+
+    batch.emplace_back(isbn, title, fields.at(columns.author).trimmed(), copies);
+    return true;
+}
+
+bool CatalogImporter::flush(std::vector<Book>& batch, ImportResult& result) {
+    if (batch.empty()) return true;
+
+    const int inserted = db.saveNewBooks(batch);
+    if (inserted < 0) return false;
+
+    result.inserted += inserted;
+    result.duplicates += static_cast<qint64>(batch.size()) - inserted;
+    batch.clear();
+    return true;
+}
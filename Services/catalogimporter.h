@@ -0,0 +1,59 @@
+#ifndef CATALOGIMPORTER_H
+#define CATALOGIMPORTER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <vector>
+
+class QIODevice;
+class DatabaseManager;
+class Book;
+
+// Kết quả của một lần nhập danh mục sách
+struct ImportResult {
+    bool ok = false;
+    qint64 rowsRead = 0;    // Số bản ghi dữ liệu (không tính dòng tiêu đề)
+    qint64 inserted = 0;    // Số sách mới được thêm
+    qint64 duplicates = 0;  // Trùng ISBN với database hoặc với dòng trước đó trong file
+    qint64 malformed = 0;   // Bản ghi sai định dạng bị bỏ qua
+    qint64 elapsedMs = 0;
+
+    double rowsPerSecond() const {
+        return elapsedMs > 0 ? rowsRead * 1000.0 / elapsedMs : double(rowsRead);
+    }
+};
+
+// Nhập danh mục sách từ CSV theo kiểu streaming: đọc từng bản ghi, gom thành lô,
+// chèn mỗi lô bằng một câu INSERT nhiều dòng, tất cả trong một transaction.
+// Nguồn có thể là file trên đĩa hoặc resource Qt (ví dụ ":/data/books.csv").
+class CatalogImporter : public QObject {
+    Q_OBJECT
+
+public:
+    explicit CatalogImporter(QObject* parent = nullptr);
+
+    ImportResult importFile(const QString& filePath);
+    ImportResult importFrom(QIODevice& device);
+
+signals:
+    void progress(qint64 rowsProcessed, double rowsPerSecond);
+
+private:
+    // Vị trí các cột trong bản ghi CSV
+    struct ColumnMap {
+        int isbn = 0;
+        int title = 1;
+        int author = 2;
+        int totalCopies = 3;
+    };
+
+    static bool isHeader(const QStringList& fields);
+    static ColumnMap mapHeader(const QStringList& fields);
+    static bool parseRecord(const QStringList& fields, const ColumnMap& columns, std::vector<Book>& batch);
+    bool flush(std::vector<Book>& batch, ImportResult& result);
+
+    DatabaseManager& db;
+};
+
+#endif // CATALOGIMPORTER_H
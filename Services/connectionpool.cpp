@@ -0,0 +1,112 @@
+#include "connectionpool.h"
+#include <QtSql/QSqlError>
+#include <QStringList>
+#include <QDebug>
+
+namespace {
+// Đủ cho toàn bộ các câu truy vấn cố định của ứng dụng
+const int STATEMENT_CACHE_CAPACITY = 64;
+
+// Các pragma áp dụng giống hệt nhau cho mọi kết nối.
+// WAL cho phép các luồng đọc chạy song song với một luồng ghi;
+// busy_timeout để luồng ghi chờ thay vì thất bại ngay khi database đang bận.
+const QStringList CONNECTION_PRAGMAS = {
+    "PRAGMA foreign_keys = ON;",
+    "PRAGMA journal_mode = WAL;",
+    "PRAGMA synchronous = NORMAL;",
+    "PRAGMA busy_timeout = 5000;"
+};
+}
+
+PooledConnection::PooledConnection(const QString& connectionName)
+    : name(connectionName), statements(STATEMENT_CACHE_CAPACITY) {
+}
+
+PooledConnection::~PooledConnection() {
+    // Mọi QSqlQuery phải được hủy trước khi gỡ bỏ kết nối
+    statements.clear();
+    if (database.isOpen()) {
+        database.close();
+    }
+    database = QSqlDatabase();
+    QSqlDatabase::removeDatabase(name);
+}
+
+ScopedQuery::ScopedQuery(const QSqlQuery& query, PooledConnection* owner, const QString& cacheKey)
+    : QSqlQuery(query), connection(owner), key(cacheKey) {
+}
+
+ScopedQuery::ScopedQuery(ScopedQuery&& other) noexcept
+    : QSqlQuery(static_cast<const QSqlQuery&>(other)), connection(other.connection), key(std::move(other.key)) {
+    // Bản cũ không còn reset hay trả câu lệnh nữa
+    other.owned = false;
+    other.connection = nullptr;
+}
+
+ScopedQuery::~ScopedQuery() {
+    if (!owned) return;
+    if (isActive()) {
+        finish();
+    }
+    if (connection) {
+        connection->leased.remove(key);
+    }
+}
+
+void ConnectionPool::setDatabasePath(const QString& newPath) {
+    std::lock_guard<std::mutex> lock(mtx);
+    path = newPath;
+}
+
+QString ConnectionPool::databasePath() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return path;
+}
+
+PooledConnection& ConnectionPool::current() {
+    if (!connections.hasLocalData()) {
+        const QString name = QString("libraryConnection_%1").arg(nextConnectionId++);
+        auto connection = new PooledConnection(name);
+        connection->database = QSqlDatabase::addDatabase("QSQLITE", name);
+        connections.setLocalData(connection);
+    }
+
+    PooledConnection& connection = *connections.localData();
+    if (!connection.database.isOpen()) {
+        openConnection(connection);
+    }
+    return connection;
+}
+
+bool ConnectionPool::openConnection(PooledConnection& connection) {
+    const QString fullPath = databasePath();
+    if (fullPath.isEmpty()) {
+        qCritical() << "ConnectionPool: database path has not been set.";
+        return false;
+    }
+
+    connection.database.setDatabaseName(fullPath);
+    if (!connection.database.open()) {
+        qCritical() << "Database connection" << connection.name << "failed:"
+                    << connection.database.lastError().text();
+        return false;
+    }
+
+    QSqlQuery pragma(connection.database);
+    for (const QString& statement : CONNECTION_PRAGMAS) {
+        if (!pragma.exec(statement)) {
+            qWarning() << "Pragma failed on" << connection.name << ":" << pragma.lastError().text();
+        }
+    }
+    pragma.finish();
+
+    qInfo() << "Opened database connection" << connection.name;
+    return true;
+}
+
+void ConnectionPool::releaseCurrentThread() {
+    if (connections.hasLocalData()) {
+        // setLocalData sẽ hủy PooledConnection cũ
+        connections.setLocalData(nullptr);
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef CONNECTIONPOOL_H
+#define CONNECTIONPOOL_H
+
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlQuery>
+#include <QSet>
+#include <QString>
+#include <QThreadStorage>
+#include <atomic>
+#include <mutex>
+#include "lrucache.h"
+
+// Một kết nối SQLite thuộc về đúng một luồng, kèm bộ nhớ đệm câu lệnh của riêng nó
+struct PooledConnection {
+    explicit PooledConnection(const QString& connectionName);
+    ~PooledConnection();
+
+    PooledConnection(const PooledConnection&) = delete;
+    PooledConnection& operator=(const PooledConnection&) = delete;
+
+    QString name;
+    QSqlDatabase database;
+    LruCache<QString, QSqlQuery> statements;
+    // SQL của các câu lệnh trong cache đang được một ScopedQuery sử dụng
+    QSet<QString> leased;
+    int transactionDepth = 0; // Số TransactionScope lồng nhau đang mở
+};
+
+// Kết quả của DatabaseManager::executeQuery.
+// Khi bị hủy, câu lệnh được reset (finish) để SQLite kết thúc read transaction ngầm định
+// và nhả snapshot WAL, rồi câu lệnh trong cache được trả lại cho lần dùng sau.
+// Chỉ giữ trong phạm vi hàm; không sao chép sang một QSqlQuery khác
+// (bản sao dùng chung kết quả và sẽ bị reset cùng lúc với ScopedQuery).
+class ScopedQuery : public QSqlQuery {
+public:
+    // owner/cacheKey chỉ có khi câu lệnh được mượn từ cache của kết nối
+    explicit ScopedQuery(const QSqlQuery& query, PooledConnection* owner = nullptr, const QString& cacheKey = QString());
+    ScopedQuery(ScopedQuery&& other) noexcept;
+    ~ScopedQuery();
+
+    ScopedQuery(const ScopedQuery&) = delete;
+    ScopedQuery& operator=(const ScopedQuery&) = delete;
+    ScopedQuery& operator=(ScopedQuery&&) = delete;
+
+private:
+    PooledConnection* connection;
+    QString key;
+    bool owned = true; // false sau khi bị move
+};
+
+// Quản lý một kết nối riêng cho mỗi luồng tới cùng một file database.
+// QSqlDatabase không thể dùng chung giữa các luồng, nên mỗi luồng sẽ được mở
+// một kết nối có tên riêng ở lần truy cập đầu tiên; kết nối được đóng và gỡ bỏ
+// khi luồng kết thúc (QThreadStorage tự hủy dữ liệu của luồng).
+class ConnectionPool {
+public:
+    ConnectionPool() = default;
+
+    ConnectionPool(const ConnectionPool&) = delete;
+    ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+    void setDatabasePath(const QString& path);
+    QString databasePath() const;
+
+    // Kết nối của luồng hiện tại, được mở lười nếu chưa có
+    PooledConnection& current();
+
+    // Đóng kết nối của luồng hiện tại (nếu có)
+    void releaseCurrentThread();
+
+private:
+    bool openConnection(PooledConnection& connection);
+
+    QThreadStorage<PooledConnection*> connections;
+    mutable std::mutex mtx;
+    QString path;
+    std::atomic<int> nextConnectionId{0};
+};
+
+#endif // CONNECTIONPOOL_H
@@ -0,0 +1,80 @@
+#include "csvreader.h"
+#include <QIODevice>
+#include <QStringConverter>
+
+namespace {
+// Số ký tự đọc mỗi lần từ thiết bị
+const qint64 READ_CHUNK_SIZE = 64 * 1024;
+const QChar BYTE_ORDER_MARK(0xFEFF);
+}
+
+CsvReader::CsvReader(QIODevice* device)
+    : stream(device), pos(0), lines(0), atStart(true) {
+    stream.setEncoding(QStringConverter::Utf8);
+}
+
+bool CsvReader::fillBuffer() {
+    do {
+        buffer = stream.read(READ_CHUNK_SIZE);
+        pos = 0;
+        if (buffer.isEmpty()) return false;
+        if (atStart) {
+            atStart = false;
+            if (buffer.at(0) == BYTE_ORDER_MARK) pos = 1;
+        }
+    } while (pos >= buffer.size());
+    return true;
+}
+
+bool CsvReader::readRecord(QStringList& fields) {
+    fields.clear();
+    QString field;
+    bool inQuotes = false;
+    bool atFieldStart = true;
+    bool consumed = false;
+
+    while (true) {
+        if (pos >= buffer.size() && !fillBuffer()) {
+            // Hết dữ liệu: bản ghi cuối cùng có thể không kết thúc bằng xuống dòng
+            if (!consumed) return false;
+            fields << field;
+            return true;
+        }
+
+        const QChar c = buffer.at(pos++);
+        consumed = true;
+
+        if (inQuotes) {
+            if (c == '"') {
+                // "" bên trong trường có nháy là một dấu nháy thật
+                if (pos >= buffer.size()) fillBuffer();
+                if (pos < buffer.size() && buffer.at(pos) == '"') {
+                    field += '"';
+                    ++pos;
+                } else {
+                    inQuotes = false;
+                }
+            } else {
+                if (c == '\n') ++lines;
+                field += c;
+            }
+            continue;
+        }
+
+        if (c == '"' && atFieldStart) {
+            inQuotes = true;
+            atFieldStart = false;
+        } else if (c == ',') {
+            fields << field;
+            field.clear();
+            atFieldStart = true;
+        } else if (c == '\n') {
+            ++lines;
+            fields << field;
+            return true;
+        } else if (c != '\r') {
+            field += c;
+            atFieldStart = false;
+        }
+    }
+}
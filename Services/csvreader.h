@@ -0,0 +1,33 @@
+#ifndef CSVREADER_H
+#define CSVREADER_H
+
+#include <QString>
+#include <QStringList>
+#include <QTextStream>
+
+class QIODevice;
+
+// Bộ đọc CSV theo RFC 4180, đọc dần từng khối nên không cần nạp cả file vào bộ nhớ.
+// Hỗ trợ trường đặt trong dấu nháy kép (có dấu phẩy, xuống dòng), "" để thoát
+// dấu nháy, kết thúc dòng CRLF/LF và bỏ qua BOM UTF-8 ở đầu file.
+class CsvReader {
+public:
+    explicit CsvReader(QIODevice* device);
+
+    // Đọc bản ghi tiếp theo vào fields; trả về false khi đã hết dữ liệu
+    bool readRecord(QStringList& fields);
+
+    // Số dòng vật lý đã đọc (dùng khi báo lỗi)
+    qint64 lineNumber() const { return lines; }
+
+private:
+    bool fillBuffer();
+
+    QTextStream stream;
+    QString buffer;
+    qsizetype pos;
+    qint64 lines;
+    bool atStart;
+};
+
+#endif // CSVREADER_H
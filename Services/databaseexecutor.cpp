@@ -0,0 +1,33 @@
+#include "databaseexecutor.h"
+
+DatabaseExecutor::DatabaseExecutor() : context(new QObject()) {
+    thread.setObjectName("DatabaseWorker");
+    context->moveToThread(&thread);
+
+    // Kết nối của luồng worker được gỡ khi luồng kết thúc (QThreadStorage),
+    // context được hủy trên chính luồng của nó
+    QObject::connect(&thread, &QThread::finished, context, &QObject::deleteLater);
+    thread.start();
+}
+
+DatabaseExecutor::~DatabaseExecutor() {
+    shutdown();
+}
+
+bool DatabaseExecutor::isStopped() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return stopped;
+}
+
+void DatabaseExecutor::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopped = true;
+    }
+    if (!thread.isRunning()) return;
+
+    // Tác vụ đang chạy được hoàn tất; các tác vụ còn trong hàng đợi bị bỏ,
+    // QPromise của chúng tự chuyển sang trạng thái canceled khi bị hủy
+    thread.quit();
+    thread.wait();
+}
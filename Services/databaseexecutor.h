@@ -0,0 +1,64 @@
+#ifndef DATABASEEXECUTOR_H
+#define DATABASEEXECUTOR_H
+
+#include <QObject>
+#include <QThread>
+#include <QFuture>
+#include <QPromise>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+
+// Luồng worker riêng cho database. Các tác vụ được xếp hàng và chạy tuần tự trên
+// luồng này, vì vậy chúng dùng kết nối riêng của luồng worker (xem ConnectionPool).
+// Kết quả trả về qua QFuture; dùng future.then(context, ...) để nhận kết quả trên
+// luồng của context (thường là luồng GUI). Tác vụ bị cancel() trước khi bắt đầu sẽ bị bỏ qua.
+// Sau shutdown(), run() không nhận tác vụ mới và trả về future đã bị hủy.
+class DatabaseExecutor {
+public:
+    DatabaseExecutor();
+    ~DatabaseExecutor();
+
+    DatabaseExecutor(const DatabaseExecutor&) = delete;
+    DatabaseExecutor& operator=(const DatabaseExecutor&) = delete;
+
+    template <typename Function>
+    auto run(Function function) -> QFuture<std::invoke_result_t<Function>> {
+        using Result = std::invoke_result_t<Function>;
+        auto promise = std::make_shared<QPromise<Result>>();
+        QFuture<Result> future = promise->future();
+        promise->start();
+
+        std::lock_guard<std::mutex> lock(mtx);
+        if (stopped) {
+            future.cancel();
+            promise->finish();
+            return future;
+        }
+        QMetaObject::invokeMethod(context, [promise, function]() {
+            if (!promise->isCanceled()) {
+                if constexpr (std::is_void_v<Result>) {
+                    function();
+                } else {
+                    promise->addResult(function());
+                }
+            }
+            promise->finish();
+        }, Qt::QueuedConnection);
+        return future;
+    }
+
+    // Dừng luồng worker; các tác vụ chưa chạy sẽ bị hủy
+    void shutdown();
+
+    bool isWorkerThread() const { return QThread::currentThread() == &thread; }
+    bool isStopped() const;
+
+private:
+    mutable std::mutex mtx;
+    bool stopped = false; // Đặt bởi shutdown(), được kiểm tra cùng khóa với việc xếp hàng tác vụ
+    QThread thread;
+    QObject* context; // Sống trên luồng worker, nhận các tác vụ được xếp hàng
+};
+
+#endif // DATABASEEXECUTOR_H
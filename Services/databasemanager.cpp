@@ -2,9 +2,13 @@
 #include "Models/person.h"
 #include "Models/book.h"
 #include "Models/transaction.h"
+#include "schemamigrator.h"
+#include "transactionscope.h"
+#include "textnormalizer.h"
 #include <QStandardPaths>
 #include <QDir>
 #include <QCoreApplication>
+#include <QRegularExpression>
 
 // Khởi tạo các biến static
 std::unique_ptr<DatabaseManager> DatabaseManager::instance = nullptr;
@@ -23,47 +27,172 @@ DatabaseManager& DatabaseManager::getInstance() {
 }
 
 bool DatabaseManager::initialize(const QString& dbPath) {
-    if (QSqlDatabase::contains("mainConnection")) {
-        database = QSqlDatabase::database("mainConnection");
-    } else {
-        database = QSqlDatabase::addDatabase("QSQLITE", "mainConnection");
-    }
-
     // SỬA ĐỔI: Thay đổi đường dẫn lưu database
     // Thay vì lưu vào AppData, chúng ta sẽ lưu vào cùng thư mục
     // với file thực thi (.exe) của chương trình.
     QString appDir = QCoreApplication::applicationDirPath();
     QString fullPath = appDir + "/" + dbPath; // dbPath là "library.db"
 
-    database.setDatabaseName(fullPath);
+    connectionPool.setDatabasePath(fullPath);
+    {
+        // Mở lại sau close(): luồng worker mới được tạo ở lần dùng tiếp theo
+        std::lock_guard<std::mutex> lock(executorMtx);
+        if (asyncExecutor && asyncExecutor->isStopped()) {
+            asyncExecutor.reset();
+        }
+    }
 
-    if (!database.open()) {
-        qCritical() << "Database connection failed:" << database.lastError().text();
+    // Các pragma (foreign keys, WAL...) được ConnectionPool áp dụng cho mọi kết nối
+    if (!database().isOpen()) {
+        qCritical() << "Database connection failed:" << database().lastError().text();
         return false;
     }
 
     qInfo() << "Database connected successfully at" << fullPath;
 
-    // Bật foreign keys để đảm bảo toàn vẹn dữ liệu
-    executeQuery("PRAGMA foreign_keys = ON;");
+    // Tạo bảng và index còn thiếu theo PRAGMA user_version
+    SchemaMigrator migrator(*this);
+    if (!migrator.migrate()) {
+        return false;
+    }
 
-    // Tạo bảng nếu chưa tồn tại
-    executeQuery("CREATE TABLE IF NOT EXISTS users (id TEXT PRIMARY KEY, name TEXT, email TEXT UNIQUE, password TEXT, user_type TEXT);");
-    executeQuery("CREATE TABLE IF NOT EXISTS books (isbn TEXT PRIMARY KEY, title TEXT, author TEXT, total_copies INTEGER, available_copies INTEGER);");
-    executeQuery("CREATE TABLE IF NOT EXISTS transactions (id INTEGER PRIMARY KEY AUTOINCREMENT, user_id TEXT, book_isbn TEXT, borrow_date TEXT, due_date TEXT, return_date TEXT, status TEXT, FOREIGN KEY(user_id) REFERENCES users(id), FOREIGN KEY(book_isbn) REFERENCES books(isbn));");
+    // books/users có khóa chính TEXT nên VACUUM có thể đánh số lại rowid mà chỉ mục FTS trỏ tới
+    if (!verifySearchIndex()) {
+        qWarning() << "Full-text search index does not match its tables, rebuilding";
+        if (!rebuildSearchIndex()) {
+            qCritical() << "Could not rebuild the full-text search index";
+        }
+    }
+
+    // Các truy vấn nóng phải dùng index, không được quét toàn bảng. EXPLAIN QUERY PLAN rẻ nên
+    // chạy ở mọi bản build để bản release cũng ghi log; bản debug dừng ngay tại đây
+    const bool plansUseIndexes = migrator.verifyHotQueryPlans();
+    if (!plansUseIndexes) {
+        qWarning() << "Some hot queries are not using their expected indexes";
+    }
+    Q_ASSERT_X(plansUseIndexes, "DatabaseManager::initialize", "hot query is not using its index");
+
+#ifndef QT_NO_DEBUG
+    // Bộ đếm thống kê phải khớp với dữ liệu thật; sửa lại nếu bị lệch
+    if (!verifyStatistics()) {
+        rebuildStatistics();
+    }
+    if (!verifyActiveLoans()) {
+        rebuildActiveLoans();
+    }
+#endif
 
     return true;
 }
 
 void DatabaseManager::close() {
-    if (database.isOpen()) {
-        database.close();
+    {
+        std::lock_guard<std::mutex> lock(executorMtx);
+        if (asyncExecutor && !asyncExecutor->isWorkerThread()) {
+            // Kết nối của luồng worker được đóng khi luồng kết thúc. Executor đã dừng được giữ lại
+            // để tác vụ gửi tới sau close() (ví dụ từ thread pool) bị từ chối thay vì tạo lại luồng.
+            asyncExecutor->shutdown();
+        }
+    }
+
+    const LruCacheStats stats = getStatementCacheStats();
+    qInfo() << "Statement cache: hits" << stats.hits << "misses" << stats.misses
+            << "evictions" << stats.evictions;
+
+    // Giải phóng các câu lệnh đã prepare và đóng kết nối của luồng này
+    connectionPool.releaseCurrentThread();
+}
+
+QSqlDatabase DatabaseManager::database() {
+    return connectionPool.current().database;
+}
+
+DatabaseExecutor& DatabaseManager::executor() {
+    std::lock_guard<std::mutex> lock(executorMtx);
+    if (!asyncExecutor) {
+        asyncExecutor = std::make_unique<DatabaseExecutor>();
+    }
+    return *asyncExecutor;
+}
+
+QFuture<QList<QSqlRecord>> DatabaseManager::executeQueryAsync(const QString& queryString, const QVariantList& params) {
+    return executor().run([this, queryString, params]() {
+        QList<QSqlRecord> rows;
+        ScopedQuery query = executeQuery(queryString, params);
+        while (query.next()) {
+            rows.append(query.record());
+        }
+        return rows;
+    });
+}
+
+QString DatabaseManager::getAppState(const QString& key) {
+    ScopedQuery query = executeQuery("SELECT value FROM app_state WHERE key = ?", {key});
+    return query.next() ? query.value(0).toString() : QString();
+}
+
+bool DatabaseManager::setAppState(const QString& key, const QString& value) {
+    ScopedQuery query = executeQuery("INSERT OR REPLACE INTO app_state (key, value) VALUES (?, ?)", {key, value});
+    return query.isActive();
+}
+
+QString DatabaseManager::nextUserId(const QString& prefix) {
+    const QString key = "user_id_seq_" + prefix;
+    int next = getAppState(key).toInt();
+    if (next <= 0) {
+        // Lần đầu: tiếp nối số lớn nhất đang dùng với tiền tố này (kể cả các ID cũ sinh ngẫu nhiên);
+        // khoảng [prefix, prefix + U+FFFF) đi theo khóa chính thay vì quét bảng
+        ScopedQuery query = executeQuery(
+            "SELECT MAX(CAST(SUBSTR(id, ?) AS INTEGER)) FROM users WHERE id >= ? AND id < ?",
+            {prefix.size() + 1, prefix, prefix + QChar(0xFFFF)});
+        next = qMax(query.next() ? query.value(0).toInt() : 0, 99) + 1;
     }
+    if (!setAppState(key, QString::number(next + 1))) return QString();
+    return prefix + QString::number(next);
+}
+
+LruCacheStats DatabaseManager::getStatementCacheStats() {
+    return connectionPool.current().statements.stats();
+}
+
+bool DatabaseManager::isCacheableStatement(const QString& queryString) {
+    // Chỉ cache DML; PRAGMA/DDL chỉ chạy một lần khi khởi tạo
+    const QString head = queryString.trimmed().left(6).toUpper();
+    return head == "SELECT" || head == "INSERT" || head == "UPDATE"
+           || head == "DELETE" || head.startsWith("WITH");
 }
 
-QSqlQuery DatabaseManager::executeQuery(const QString& queryString, const QVariantList& params) {
-    QSqlQuery query(database);
-    query.prepare(queryString);
+ScopedQuery DatabaseManager::acquireStatement(const QString& queryString) {
+    PooledConnection& connection = connectionPool.current();
+    // PRAGMA/DDL chỉ chạy một lần khi khởi tạo; cùng SQL đang được dùng ở mức ngoài (gọi lồng nhau)
+    // thì dùng câu lệnh riêng để không reset kết quả người gọi đang đọc dở
+    // Mọi câu lệnh đều forward-only: ở chế độ mặc định driver giữ lại mọi dòng đã đọc cho tới lần exec kế tiếp,
+    // tức là nhân đôi bộ nhớ khi đọc cả danh mục vào snapshot. Không người gọi nào cần seek/previous
+    if (!isCacheableStatement(queryString) || connection.leased.contains(queryString)) {
+        QSqlQuery query(connection.database);
+        query.setForwardOnly(true);
+        query.prepare(queryString);
+        return ScopedQuery(query);
+    }
+
+    if (QSqlQuery* cached = connection.statements.find(queryString)) {
+        // Câu lệnh đã được ScopedQuery trước đó reset khi trả lại
+        connection.leased.insert(queryString);
+        return ScopedQuery(*cached, &connection, queryString);
+    }
+
+    QSqlQuery query(connection.database);
+    query.setForwardOnly(true);
+    if (!query.prepare(queryString)) {
+        return ScopedQuery(query);
+    }
+    connection.statements.insert(queryString, query);
+    connection.leased.insert(queryString);
+    return ScopedQuery(query, &connection, queryString);
+}
+
+ScopedQuery DatabaseManager::executeQuery(const QString& queryString, const QVariantList& params) {
+    ScopedQuery query = acquireStatement(queryString);
     for (int i = 0; i < params.size(); ++i) {
         query.bindValue(i, params.at(i));
     }
@@ -76,92 +205,362 @@ QSqlQuery DatabaseManager::executeQuery(const QString& queryString, const QVaria
 
 // --- Implement các hàm truy vấn ---
 
-QSqlQuery DatabaseManager::getUserDataByEmail(const QString& email) {
+ScopedQuery DatabaseManager::getUserDataByEmail(const QString& email) {
     return executeQuery("SELECT * FROM users WHERE email = ?", {email});
 }
 
-QSqlQuery DatabaseManager::getBookDataByIsbn(const QString& isbn) {
+ScopedQuery DatabaseManager::getBookDataByIsbn(const QString& isbn) {
     return executeQuery("SELECT * FROM books WHERE isbn = ?", {isbn});
 }
 
-QSqlQuery DatabaseManager::getAllBooksData() {
+ScopedQuery DatabaseManager::getAllBooksData() {
     return executeQuery("SELECT * FROM books ORDER BY title");
 }
 
-QSqlQuery DatabaseManager::getTransactionsDataByUserId(const QString& userId) {
-    return executeQuery("SELECT * FROM transactions WHERE user_id = ? ORDER BY borrow_date DESC", {userId});
+ScopedQuery DatabaseManager::getTransactionsDataByUserId(const QString& userId) {
+    return executeQuery("SELECT t.*, b.title AS book_title FROM transactions t LEFT JOIN books b ON t.book_isbn = b.isbn "
+                        "WHERE t.user_id = ? ORDER BY t.borrow_date DESC", {userId});
 }
 
-QSqlQuery DatabaseManager::getActiveTransactionData(const QString& userId, const QString& bookIsbn) {
+ScopedQuery DatabaseManager::getActiveTransactionData(const QString& userId, const QString& bookIsbn) {
     return executeQuery("SELECT * FROM transactions WHERE user_id = ? AND book_isbn = ? AND status = 'Active'", {userId, bookIsbn});
 }
 
 // Sửa: Nhận mật khẩu đã được băm
 bool DatabaseManager::saveNewUser(const Person& user, const QString& hashedPassword) {
-    QSqlQuery query = executeQuery("INSERT INTO users (id, name, email, password, user_type) VALUES (?, ?, ?, ?, ?)",
-                                   {user.getUserId(), user.getName(), user.getEmail(), hashedPassword, user.getUserType()});
+    ScopedQuery query = executeQuery("INSERT INTO users (id, name, email, password, user_type, name_norm) VALUES (?, ?, ?, ?, ?, ?)",
+                                   {user.getUserId(), user.getName(), user.getEmail(), hashedPassword, user.getUserType(),
+                                    TextNormalizer::normalize(user.getName())});
     return query.isActive();
 }
 
+bool DatabaseManager::upgradeUserPassword(const QString& userId, const QString& oldHash, const QString& newHash) {
+    ScopedQuery query = executeQuery("UPDATE users SET password = ? WHERE id = ? AND password = ?",
+                                   {newHash, userId, oldHash});
+    return query.isActive() && query.numRowsAffected() == 1;
+}
+
 bool DatabaseManager::saveNewBook(const Book& book) {
-    QSqlQuery query = executeQuery("INSERT INTO books (isbn, title, author, total_copies, available_copies) VALUES (?, ?, ?, ?, ?)",
-                                   {book.getIsbn(), book.getTitle(), book.getAuthor(), book.getTotalCopies(), book.getAvailableCopies()});
+    ScopedQuery query = executeQuery("INSERT INTO books (isbn, title, author, total_copies, available_copies, title_norm, author_norm) VALUES (?, ?, ?, ?, ?, ?, ?)",
+                                   {book.getIsbn(), book.getTitle(), book.getAuthor(), book.getTotalCopies(), book.getAvailableCopies(),
+                                    TextNormalizer::normalize(book.getTitle()), TextNormalizer::normalize(book.getAuthor())});
     return query.isActive();
 }
 
+int DatabaseManager::saveNewBooks(const std::vector<Book>& books) {
+    if (books.empty()) return 0;
+
+    // Các lô có cùng kích thước dùng chung một chuỗi SQL nên được cache như một câu lệnh
+    QStringList rows;
+    rows.reserve(static_cast<int>(books.size()));
+    QVariantList params;
+    params.reserve(static_cast<int>(books.size()) * 7);
+    for (const Book& book : books) {
+        rows << "(?, ?, ?, ?, ?, ?, ?)";
+        params << book.getIsbn() << book.getTitle() << book.getAuthor()
+               << book.getTotalCopies() << book.getAvailableCopies()
+               << TextNormalizer::normalize(book.getTitle()) << TextNormalizer::normalize(book.getAuthor());
+    }
+
+    ScopedQuery query = executeQuery("INSERT OR IGNORE INTO books (isbn, title, author, total_copies, available_copies, title_norm, author_norm) VALUES "
+                                   + rows.join(", "), params);
+    return query.isActive() ? query.numRowsAffected() : -1;
+}
+
 bool DatabaseManager::saveNewTransaction(const Transaction& transaction) {
-    QSqlQuery query = executeQuery("INSERT INTO transactions (user_id, book_isbn, borrow_date, due_date, status) VALUES (?, ?, ?, ?, 'Active')",
+    ScopedQuery query = executeQuery("INSERT INTO transactions (user_id, book_isbn, borrow_date, due_date, status) VALUES (?, ?, ?, ?, 'Active')",
                                    {transaction.getUserId(), transaction.getBookIsbn(), transaction.getBorrowDate().toString(Qt::ISODate), transaction.getDueDate().toString(Qt::ISODate)});
     return query.isActive();
 }
 
 bool DatabaseManager::updateBookCopies(const QString& isbn, int availableCopies) {
-    QSqlQuery query = executeQuery("UPDATE books SET available_copies = ? WHERE isbn = ?",
+    ScopedQuery query = executeQuery("UPDATE books SET available_copies = ? WHERE isbn = ?",
                                    {availableCopies, isbn});
     return query.isActive();
 }
 
 bool DatabaseManager::updateTransactionOnReturn(int transactionId) {
-    QSqlQuery query = executeQuery("UPDATE transactions SET return_date = ?, status = 'Completed' WHERE id = ?",
+    ScopedQuery query = executeQuery("UPDATE transactions SET return_date = ?, status = 'Completed' WHERE id = ?",
                                    {QDateTime::currentDateTime().toString(Qt::ISODate), transactionId});
     return query.isActive();
 }
 
+bool DatabaseManager::beginTransaction() {
+    PooledConnection& connection = connectionPool.current();
+    QSqlQuery query(connection.database);
+
+    if (connection.transactionDepth == 0) {
+        // Câu lệnh đã trả về cache luôn được reset (xem ScopedQuery); chỉ các câu lệnh
+        // người gọi còn đang đọc dở mới còn mở và chúng không được reset ở đây
+        if (!query.exec("BEGIN IMMEDIATE")) {
+            qWarning() << "Could not begin transaction:" << query.lastError().text();
+            return false;
+        }
+    } else if (!query.exec(QString("SAVEPOINT sp_%1").arg(connection.transactionDepth))) {
+        qWarning() << "Could not create savepoint:" << query.lastError().text();
+        return false;
+    }
+
+    ++connection.transactionDepth;
+    return true;
+}
+
+bool DatabaseManager::commitTransaction() {
+    PooledConnection& connection = connectionPool.current();
+    if (connection.transactionDepth == 0) return false;
+
+    const int level = connection.transactionDepth - 1;
+    QSqlQuery query(connection.database);
+    const QString statement = level == 0 ? QString("COMMIT") : QString("RELEASE sp_%1").arg(level);
+    if (!query.exec(statement)) {
+        qWarning() << "Could not commit transaction:" << query.lastError().text();
+        return false;
+    }
+
+    --connection.transactionDepth;
+    return true;
+}
+
+void DatabaseManager::rollbackTransaction() {
+    PooledConnection& connection = connectionPool.current();
+    if (connection.transactionDepth == 0) return;
+
+    const int level = --connection.transactionDepth;
+    QSqlQuery query(connection.database);
+    if (level == 0) {
+        if (!query.exec("ROLLBACK")) {
+            qWarning() << "Could not roll back transaction:" << query.lastError().text();
+        }
+        return;
+    }
+
+    // Hoàn tác về savepoint rồi gỡ nó khỏi ngăn xếp savepoint
+    if (!query.exec(QString("ROLLBACK TO sp_%1").arg(level))
+        || !query.exec(QString("RELEASE sp_%1").arg(level))) {
+        qWarning() << "Could not roll back to savepoint:" << query.lastError().text();
+    }
+}
+
+bool DatabaseManager::checkoutBook(const Transaction& transaction, int maxActiveLoans, int* newTransactionId,
+                                   int* availableCopies) {
+    TransactionScope scope(*this);
+    if (!scope.isActive()) return false;
+
+    // Tăng số khoản đang mượn chỉ khi người dùng tồn tại và chưa đạt giới hạn
+    ScopedQuery reserve = executeQuery(
+        "UPDATE users SET active_loans = active_loans + 1 WHERE id = ? AND active_loans < ?",
+        {transaction.getUserId(), maxActiveLoans});
+    if (reserve.numRowsAffected() != 1) {
+        return false;
+    }
+
+    // Giảm số bản có sẵn chỉ khi còn sách
+    ScopedQuery decrement = executeQuery(
+        "UPDATE books SET available_copies = available_copies - 1 WHERE isbn = ? AND available_copies > 0",
+        {transaction.getBookIsbn()});
+    if (decrement.numRowsAffected() != 1) {
+        return false;
+    }
+
+    if (!saveNewTransaction(transaction)) {
+        return false;
+    }
+    if (newTransactionId) {
+        // Cùng kết nối và cùng transaction nên last_insert_rowid() là giao dịch vừa ghi
+        ScopedQuery idQuery = executeQuery("SELECT last_insert_rowid()");
+        *newTransactionId = idQuery.next() ? idQuery.value(0).toInt() : 0;
+    }
+    const int available = availableCopiesInTransaction(transaction.getBookIsbn());
+    if (!scope.commit()) return false;
+    if (availableCopies) *availableCopies = available;
+    return true;
+}
+
+bool DatabaseManager::checkinBook(int transactionId, QString* bookIsbn, int* availableCopies) {
+    TransactionScope scope(*this);
+    if (!scope.isActive()) return false;
+
+    // Chỉ hoàn tất giao dịch chưa được trả
+    ScopedQuery complete = executeQuery(
+        "UPDATE transactions SET return_date = ?, status = 'Completed' WHERE id = ? AND status != 'Completed'",
+        {QDateTime::currentDateTime().toString(Qt::ISODate), transactionId});
+    if (complete.numRowsAffected() != 1) {
+        return false;
+    }
+
+    ScopedQuery loanQuery = executeQuery("SELECT book_isbn, user_id FROM transactions WHERE id = ?", {transactionId});
+    if (!loanQuery.next()) return false;
+    const QString isbn = loanQuery.value(0).toString();
+
+    ScopedQuery release = executeQuery(
+        "UPDATE users SET active_loans = active_loans - 1 WHERE id = ? AND active_loans > 0",
+        {loanQuery.value(1).toString()});
+    if (!release.isActive()) {
+        return false;
+    }
+
+    ScopedQuery increment = executeQuery(
+        "UPDATE books SET available_copies = available_copies + 1 "
+        "WHERE isbn = ? AND available_copies < total_copies",
+        {isbn});
+    if (!increment.isActive()) {
+        return false;
+    }
+    if (increment.numRowsAffected() != 1) {
+        qWarning() << "Book for transaction" << transactionId << "not found. Cannot update copy count, but will complete transaction.";
+    }
+    const int available = availableCopiesInTransaction(isbn);
+
+    if (!scope.commit()) return false;
+    if (bookIsbn) *bookIsbn = isbn;
+    if (availableCopies) *availableCopies = available;
+    return true;
+}
+
+int DatabaseManager::availableCopiesInTransaction(const QString& isbn) {
+    // Đọc trong transaction đang giữ khóa ghi nên chính là giá trị được commit
+    ScopedQuery query = executeQuery("SELECT available_copies FROM books WHERE isbn = ?", {isbn});
+    return query.next() ? query.value(0).toInt() : -1;
+}
+
+bool DatabaseManager::verifyCopyCounts() {
+    ScopedQuery query = executeQuery(R"(
+        SELECT b.isbn, b.available_copies, b.total_copies - COUNT(t.id) AS expected
+        FROM books b
+        LEFT JOIN transactions t ON t.book_isbn = b.isbn AND t.status IN ('Active', 'Overdue')
+        GROUP BY b.isbn
+        HAVING b.available_copies != expected
+    )");
+
+    bool consistent = true;
+    while (query.next()) {
+        qWarning() << "Copy count drift for ISBN" << query.value(0).toString()
+                   << ": available" << query.value(1).toInt() << "expected" << query.value(2).toInt();
+        consistent = false;
+    }
+    return consistent;
+}
+
+bool DatabaseManager::verifyActiveLoans() {
+    ScopedQuery query = executeQuery(R"(
+        SELECT u.id, u.active_loans,
+               (SELECT COUNT(*) FROM transactions t WHERE t.user_id = u.id AND t.status IN ('Active', 'Overdue')) AS expected
+        FROM users u
+        WHERE u.active_loans != expected
+    )");
+
+    bool consistent = true;
+    while (query.next()) {
+        qWarning() << "Active loan drift for user" << query.value(0).toString()
+                   << ": counter" << query.value(1).toInt() << "actual" << query.value(2).toInt();
+        consistent = false;
+    }
+    return consistent;
+}
+
+bool DatabaseManager::rebuildActiveLoans() {
+    ScopedQuery query = executeQuery(
+        "UPDATE users SET active_loans = (SELECT COUNT(*) FROM transactions t "
+        "WHERE t.user_id = users.id AND t.status IN ('Active', 'Overdue'))");
+    return query.isActive();
+}
+
 // Sửa: Tách riêng available copies để logic được tập trung hơn
 bool DatabaseManager::updateBook(const Book& book, int newAvailableCopies) {
-    QSqlQuery query = executeQuery("UPDATE books SET title = ?, author = ?, total_copies = ?, available_copies = ? WHERE isbn = ?",
-                                   {book.getTitle(), book.getAuthor(), book.getTotalCopies(), newAvailableCopies, book.getIsbn()});
+    ScopedQuery query = executeQuery("UPDATE books SET title = ?, author = ?, total_copies = ?, available_copies = ?, title_norm = ?, author_norm = ? WHERE isbn = ?",
+                                   {book.getTitle(), book.getAuthor(), book.getTotalCopies(), newAvailableCopies,
+                                    TextNormalizer::normalize(book.getTitle()), TextNormalizer::normalize(book.getAuthor()), book.getIsbn()});
     return query.isActive();
 }
 
 bool DatabaseManager::deleteBook(const QString& isbn) {
     // Kiểm tra xem sách có đang được mượn không
-    QSqlQuery checkQuery = executeQuery("SELECT COUNT(*) FROM transactions WHERE book_isbn = ? AND (status = 'Active' OR status = 'Overdue')", {isbn});
+    ScopedQuery checkQuery = executeQuery("SELECT COUNT(*) FROM transactions WHERE book_isbn = ? AND status IN ('Active', 'Overdue')", {isbn});
     if (checkQuery.next() && checkQuery.value(0).toInt() > 0) {
         qWarning() << "Delete book failed: Book is currently borrowed.";
         return false;
     }
 
-    QSqlQuery query = executeQuery("DELETE FROM books WHERE isbn = ?", {isbn});
+    ScopedQuery query = executeQuery("DELETE FROM books WHERE isbn = ?", {isbn});
     return query.isActive();
 }
 
+bool DatabaseManager::deactivateUser(const QString& userId) {
+    // Điều kiện active_loans = 0 được kiểm tra trong cùng câu lệnh cập nhật, không đọc trước
+    ScopedQuery query = executeQuery(
+        "UPDATE users SET status = 'Inactive' WHERE id = ? AND active_loans = 0 AND status <> 'Inactive'", {userId});
+    if (query.numRowsAffected() != 1) {
+        qWarning() << "Deactivate user failed: User" << userId << "does not exist, is already inactive or still has books on loan.";
+        return false;
+    }
+    return true;
+}
+
 int DatabaseManager::getBookCount() {
-    QSqlQuery query = executeQuery("SELECT COUNT(*) FROM books");
+    ScopedQuery query = executeQuery("SELECT COUNT(*) FROM books");
     return query.next() ? query.value(0).toInt() : 0;
 }
 
 int DatabaseManager::getUserCount() {
-    QSqlQuery query = executeQuery("SELECT COUNT(*) FROM users");
+    ScopedQuery query = executeQuery("SELECT COUNT(*) FROM users");
     return query.next() ? query.value(0).toInt() : 0;
 }
 
 int DatabaseManager::getActiveTransactionCount() {
-    QSqlQuery query = executeQuery("SELECT COUNT(*) FROM transactions WHERE status = 'Active'");
+    ScopedQuery query = executeQuery("SELECT COUNT(*) FROM transactions WHERE status = 'Active'");
+    return query.next() ? query.value(0).toInt() : 0;
+}
+
+int DatabaseManager::getOverdueTransactionCount() {
+    ScopedQuery query = executeQuery("SELECT COUNT(*) FROM transactions WHERE status = 'Overdue'");
     return query.next() ? query.value(0).toInt() : 0;
 }
 
-QSqlQuery DatabaseManager::getAllTransactionsData() {
+LibraryStatistics DatabaseManager::getStatistics() {
+    LibraryStatistics stats;
+    ScopedQuery query = executeQuery(
+        "SELECT total_books, total_users, active_transactions, overdue_transactions FROM library_stats WHERE id = 1");
+    if (query.next()) {
+        stats.totalBooks = query.value(0).toInt();
+        stats.totalUsers = query.value(1).toInt();
+        stats.activeTransactions = query.value(2).toInt();
+        stats.overdueTransactions = query.value(3).toInt();
+    }
+    return stats;
+}
+
+bool DatabaseManager::rebuildStatistics() {
+    ScopedQuery query = executeQuery(R"(
+        UPDATE library_stats SET
+            total_books = (SELECT COUNT(*) FROM books),
+            total_users = (SELECT COUNT(*) FROM users),
+            active_transactions = (SELECT COUNT(*) FROM transactions WHERE status = 'Active'),
+            overdue_transactions = (SELECT COUNT(*) FROM transactions WHERE status = 'Overdue')
+        WHERE id = 1
+    )");
+    return query.isActive();
+}
+
+bool DatabaseManager::verifyStatistics() {
+    const LibraryStatistics counters = getStatistics();
+    const LibraryStatistics actual{getBookCount(), getUserCount(),
+                                   getActiveTransactionCount(), getOverdueTransactionCount()};
+
+    bool consistent = true;
+    auto check = [&consistent](const char* name, int counter, int expected) {
+        if (counter != expected) {
+            qWarning() << "Statistics drift for" << name << ": counter" << counter << "actual" << expected;
+            consistent = false;
+        }
+    };
+    check("total_books", counters.totalBooks, actual.totalBooks);
+    check("total_users", counters.totalUsers, actual.totalUsers);
+    check("active_transactions", counters.activeTransactions, actual.activeTransactions);
+    check("overdue_transactions", counters.overdueTransactions, actual.overdueTransactions);
+    return consistent;
+}
+
+ScopedQuery DatabaseManager::getAllTransactionsData() {
     // Sử dụng JOIN để lấy thêm tên người dùng và tên sách hiệu quả
     QString queryString = R"(
         SELECT t.*, u.name AS user_name, b.title AS book_title
@@ -174,11 +573,192 @@ QSqlQuery DatabaseManager::getAllTransactionsData() {
     return executeQuery(queryString);
 }
 
-QSqlQuery DatabaseManager::getTransactionById(int transactionId) {
+ScopedQuery DatabaseManager::getBooksPageData(const PageCursor& cursor, int limit, PageDirection direction) {
+    const bool forward = direction == PageDirection::Forward;
+    const QString order = forward ? "ORDER BY title, isbn" : "ORDER BY title DESC, isbn DESC";
+
+    if (cursor.isNull()) {
+        return executeQuery("SELECT * FROM books " + order + " LIMIT ?", {limit});
+    }
+    const QString seek = forward ? "WHERE (title, isbn) > (?, ?) " : "WHERE (title, isbn) < (?, ?) ";
+    return executeQuery("SELECT * FROM books " + seek + order + " LIMIT ?",
+                        {cursor.sortKey, cursor.tieBreaker, limit});
+}
+
+QString DatabaseManager::buildMatchExpression(const QString& searchTerm) {
+    // Chuẩn hóa giống cột title_norm/author_norm, rồi chỉ giữ chữ và số
+    // nên các từ không thể chứa cú pháp FTS5 (dấu ngoặc kép, toán tử...)
+    static const QRegularExpression separators("[^\\p{L}\\p{N}]+");
+    const QStringList words = TextNormalizer::normalize(searchTerm).split(separators, Qt::SkipEmptyParts);
+
+    QStringList terms;
+    for (const QString& word : words) {
+        terms << QString("\"%1\"*").arg(word);
+    }
+    return terms.join(' ');
+}
+
+ScopedQuery DatabaseManager::searchBooksData(const QString& searchTerm, int limit) {
+    const QString match = buildMatchExpression(searchTerm);
+    if (match.isEmpty()) {
+        return ScopedQuery(QSqlQuery(database()));
+    }
+    return executeQuery(R"(
+        SELECT b.* FROM books_fts
+        JOIN books b ON b.rowid = books_fts.rowid
+        WHERE books_fts MATCH ?
+        ORDER BY books_fts.rank
+        LIMIT ?
+    )", {match, limit});
+}
+
+bool DatabaseManager::rebuildSearchIndex() {
+    return executeQuery("INSERT INTO books_fts(books_fts) VALUES('rebuild')").isActive()
+        && executeQuery("INSERT INTO users_fts(users_fts) VALUES('rebuild')").isActive();
+}
+
+bool DatabaseManager::verifySearchIndex() {
+    // rank = 1: đối chiếu cả với nội dung bảng gốc; mặc định chỉ kiểm tra cấu trúc của chính chỉ mục
+    return executeQuery("INSERT INTO books_fts(books_fts, rank) VALUES('integrity-check', 1)").isActive()
+        && executeQuery("INSERT INTO users_fts(users_fts, rank) VALUES('integrity-check', 1)").isActive();
+}
+
+ScopedQuery DatabaseManager::getTransactionsPageData(const PageCursor& cursor, int limit, PageDirection direction,
+                                                  const TransactionFilter& filter) {
+    const QString select = R"(
+        SELECT t.*, u.name AS user_name, b.title AS book_title
+        FROM transactions t
+        LEFT JOIN users u ON t.user_id = u.id
+        LEFT JOIN books b ON t.book_isbn = b.isbn
+    )";
+    // "Forward" đi từ mới đến cũ
+    const bool forward = direction == PageDirection::Forward;
+    const QString order = forward ? "ORDER BY t.borrow_date DESC, t.id DESC"
+                                  : "ORDER BY t.borrow_date, t.id";
+
+    // Mỗi tổ hợp điều kiện là một chuỗi SQL cố định nên vẫn được cache như câu lệnh đã chuẩn bị
+    QStringList conditions;
+    QVariantList params;
+    if (filter.status) {
+        conditions << "t.status = ?";
+        params << transactionStatusText(*filter.status);
+    }
+    if (filter.from.isValid()) {
+        conditions << "t.borrow_date >= ?";
+        params << filter.from.toString(Qt::ISODate);
+    }
+    if (filter.to.isValid()) {
+        conditions << "t.borrow_date < ?";
+        params << filter.to.toString(Qt::ISODate);
+    }
+    if (!cursor.isNull()) {
+        conditions << (forward ? "(t.borrow_date, t.id) < (?, ?)" : "(t.borrow_date, t.id) > (?, ?)");
+        params << cursor.sortKey << cursor.tieBreaker;
+    }
+
+    QString sql = select;
+    if (!conditions.isEmpty()) {
+        sql += "WHERE " + conditions.join(" AND ") + " ";
+    }
+    params << limit;
+    return executeQuery(sql + order + " LIMIT ?", params);
+}
+
+void DatabaseManager::appendUserConditions(const UserFilter& filter, QStringList& conditions, QVariantList& params) {
+    if (!filter.userType.isEmpty()) {
+        conditions << "u.user_type = ?";
+        params << filter.userType;
+    }
+    if (!filter.status.isEmpty()) {
+        conditions << "u.status = ?";
+        params << filter.status;
+    }
+    const QString match = buildMatchExpression(filter.text);
+    if (!match.isEmpty()) {
+        conditions << "u.rowid IN (SELECT rowid FROM users_fts WHERE users_fts MATCH ?)";
+        params << match;
+    }
+}
+
+ScopedQuery DatabaseManager::getUsersPageData(const PageCursor& cursor, int limit, PageDirection direction,
+                                           const UserFilter& filter) {
+    // "Forward" đi theo chiều sắp xếp của filter
+    const bool ascending = (filter.sortOrder == Qt::AscendingOrder) == (direction == PageDirection::Forward);
+    const QString dir = ascending ? "" : " DESC";
+    const QString cmp = ascending ? ">" : "<";
+
+    QStringList conditions;
+    QVariantList params;
+    appendUserConditions(filter, conditions, params);
+
+    // email và id là duy nhất nên chỉ cần một cột làm khóa phân trang
+    QString order;
+    switch (filter.sortColumn) {
+    case UserSortColumn::Email:
+        order = "ORDER BY u.email" + dir;
+        if (!cursor.isNull()) {
+            conditions << "u.email " + cmp + " ?";
+            params << cursor.sortKey;
+        }
+        break;
+    case UserSortColumn::Id:
+        order = "ORDER BY u.id" + dir;
+        if (!cursor.isNull()) {
+            conditions << "u.id " + cmp + " ?";
+            params << cursor.sortKey;
+        }
+        break;
+    case UserSortColumn::Name:
+    default:
+        order = "ORDER BY u.name" + dir + ", u.id" + dir;
+        if (!cursor.isNull()) {
+            conditions << "(u.name, u.id) " + cmp + " (?, ?)";
+            params << cursor.sortKey << cursor.tieBreaker;
+        }
+        break;
+    }
+
+    QString sql = "SELECT u.id, u.name, u.email, u.user_type, u.status, u.active_loans FROM users u ";
+    if (!conditions.isEmpty()) {
+        sql += "WHERE " + conditions.join(" AND ") + " ";
+    }
+    params << limit;
+    return executeQuery(sql + order + " LIMIT ?", params);
+}
+
+UserCounts DatabaseManager::getUserCounts(const UserFilter& filter) {
+    QStringList conditions;
+    QVariantList params;
+    appendUserConditions(filter, conditions, params);
+
+    QString sql = "SELECT COUNT(*), COALESCE(SUM(u.status = 'Active'), 0) FROM users u";
+    if (!conditions.isEmpty()) {
+        sql += " WHERE " + conditions.join(" AND ");
+    }
+    UserCounts counts;
+    ScopedQuery query = executeQuery(sql, params);
+    if (query.next()) {
+        counts.total = query.value(0).toInt();
+        counts.active = query.value(1).toInt();
+    }
+    return counts;
+}
+
+ScopedQuery DatabaseManager::getTransactionById(int transactionId) {
     return executeQuery("SELECT * FROM transactions WHERE id = ?", {transactionId});
 }
 
+ScopedQuery DatabaseManager::getTransactionDetailsById(int transactionId) {
+    return executeQuery(R"(
+        SELECT t.*, u.name AS user_name, b.title AS book_title
+        FROM transactions t
+        LEFT JOIN users u ON t.user_id = u.id
+        LEFT JOIN books b ON t.book_isbn = b.isbn
+        WHERE t.id = ?
+    )", {transactionId});
+}
+
 // THÊM ĐỊNH NGHĨA CHO HÀM MỚI
-QSqlQuery DatabaseManager::getUserDataById(const QString& userId) {
+ScopedQuery DatabaseManager::getUserDataById(const QString& userId) {
     return executeQuery("SELECT * FROM users WHERE id = ?", {userId});
 }
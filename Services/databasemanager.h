@@ -4,25 +4,70 @@
 #include <QtSql/QSqlDatabase>
 #include <QtSql/QSqlQuery>
 #include <QtSql/QSqlError>
+#include <QtSql/QSqlRecord>
+#include <QFuture>
+#include <QList>
 #include <QString>
 #include <QDebug>
 #include <memory>
 #include <mutex>
+#include <vector>
+#include "connectionpool.h"
+#include "databaseexecutor.h"
+#include "pagination.h"
+#include "transactionfilter.h"
+#include "userdirectory.h"
 
 // Forward declarations
 class Person;
 class Book;
 class Transaction;
 
+// Các số liệu hiển thị trên Dashboard
+struct LibraryStatistics {
+    int totalBooks = 0;
+    int totalUsers = 0;
+    int activeTransactions = 0;
+    int overdueTransactions = 0;
+
+    bool operator==(const LibraryStatistics& other) const {
+        return totalBooks == other.totalBooks && totalUsers == other.totalUsers
+            && activeTransactions == other.activeTransactions && overdueTransactions == other.overdueTransactions;
+    }
+    bool operator!=(const LibraryStatistics& other) const { return !(*this == other); }
+};
+
 class DatabaseManager {
 private:
     // Singleton Pattern Implementation
     static std::unique_ptr<DatabaseManager> instance;
     static std::mutex mtx;
-    QSqlDatabase database;
+    // Mỗi luồng có kết nối và bộ nhớ đệm câu lệnh riêng
+    ConnectionPool connectionPool;
+    // Luồng worker cho các thao tác bất đồng bộ, được tạo ở lần dùng đầu tiên
+    std::unique_ptr<DatabaseExecutor> asyncExecutor;
+    std::mutex executorMtx;
 
     DatabaseManager(); // Constructor riêng tư
 
+    ScopedQuery acquireStatement(const QString& queryString);
+    static bool isCacheableStatement(const QString& queryString);
+    // Chuyển chuỗi người dùng nhập (đã chuẩn hóa) thành biểu thức MATCH của FTS5: mỗi từ được đặt trong
+    // ngoặc kép và khớp theo tiền tố ("tieng"* "vie"*), các từ được nối bằng AND ngầm định
+    static QString buildMatchExpression(const QString& searchTerm);
+    // Điều kiện WHERE (alias u) dùng chung cho trang người dùng và truy vấn đếm
+    static void appendUserConditions(const UserFilter& filter, QStringList& conditions, QVariantList& params);
+    // Số bản có sẵn hiện tại của sách (-1 nếu không có), gọi trong checkoutBook/checkinBook trước COMMIT
+    int availableCopiesInTransaction(const QString& isbn);
+
+    // Dùng qua TransactionScope. Mức ngoài cùng là BEGIN IMMEDIATE/COMMIT,
+    // các mức lồng bên trong là SAVEPOINT/RELEASE trên cùng kết nối.
+    // Kết quả truy vấn đọc trước đó đã được ScopedQuery reset nên không giữ snapshot cũ.
+    friend class TransactionScope;
+    bool beginTransaction();
+    bool commitTransaction();
+    void rollbackTransaction();
+
 public:
     // Xóa copy constructor và toán tử gán
     DatabaseManager(const DatabaseManager&) = delete;
@@ -33,34 +78,117 @@ public:
 
     // Khởi tạo và kết nối database
     bool initialize(const QString& dbPath = "library.db");
+    // Đóng kết nối của luồng đang gọi (và dừng luồng worker nếu gọi từ luồng khác)
     void close();
 
+    // Luồng worker database: executor().run(fn) chạy fn trên kết nối của luồng worker
+    // và trả về QFuture; nhận kết quả trên luồng GUI bằng future.then(context, ...).
+    // Sau close(), tác vụ mới bị từ chối (future bị hủy) cho tới lần initialize() tiếp theo.
+    // Mọi hàm của DatabaseManager đều có thể chạy trong fn, nhưng QSqlQuery không được
+    // mang ra khỏi fn; hãy chuyển kết quả thành giá trị (model, QSqlRecord, số...).
+    DatabaseExecutor& executor();
+
+    // Kết nối của luồng hiện tại (mở lười ở lần gọi đầu tiên)
+    QSqlDatabase database();
+
     // --- Các hàm thao tác với Database ---
 
     // Lấy dữ liệu
-    QSqlQuery getUserDataByEmail(const QString& email);
-    QSqlQuery getUserDataById(const QString& userId);
-    QSqlQuery getBookDataByIsbn(const QString& isbn);
-    QSqlQuery getAllBooksData();
-    QSqlQuery getTransactionsDataByUserId(const QString& userId);
-    QSqlQuery getActiveTransactionData(const QString& userId, const QString& bookIsbn);
-    QSqlQuery getAllTransactionsData();
-    QSqlQuery getTransactionById(int transactionId);
-    QSqlQuery executeQuery(const QString& queryString, const QVariantList& params = {});
+    ScopedQuery getUserDataByEmail(const QString& email);
+    ScopedQuery getUserDataById(const QString& userId);
+    ScopedQuery getBookDataByIsbn(const QString& isbn);
+    ScopedQuery getAllBooksData();
+    ScopedQuery getTransactionsDataByUserId(const QString& userId);
+    ScopedQuery getActiveTransactionData(const QString& userId, const QString& bookIsbn);
+    ScopedQuery getAllTransactionsData();
+    ScopedQuery getTransactionById(int transactionId);
+    // Một giao dịch kèm tên người dùng và tên sách (giống getAllTransactionsData)
+    ScopedQuery getTransactionDetailsById(int transactionId);
+    // Câu lệnh DML được prepare một lần cho mỗi luồng và được tái sử dụng.
+    // Câu lệnh được mượn từ cache trong suốt thời gian sống của ScopedQuery và được reset khi
+    // nó bị hủy; gọi lồng nhau cùng chuỗi SQL sẽ dùng một câu lệnh riêng.
+    ScopedQuery executeQuery(const QString& queryString, const QVariantList& params = {});
+    // Phiên bản bất đồng bộ của executeQuery: chạy trên luồng worker, trả về các dòng kết quả
+    QFuture<QList<QSqlRecord>> executeQueryAsync(const QString& queryString, const QVariantList& params = {});
+
+    // Phân trang keyset (seek) trên cột có index, không dùng OFFSET.
+    // Trả về tối đa limit dòng đứng sau/trước cursor; hướng Backward trả về theo thứ tự ngược.
+    // Sách: thứ tự (title, isbn); cursor = {title, isbn}
+    ScopedQuery getBooksPageData(const PageCursor& cursor, int limit, PageDirection direction);
+    // Giao dịch mới nhất trước: thứ tự (borrow_date DESC, id DESC); cursor = {borrow_date, id}.
+    // Lọc theo trạng thái và khoảng ngày mượn ngay trong SQL (index (status, borrow_date) hoặc borrow_date)
+    ScopedQuery getTransactionsPageData(const PageCursor& cursor, int limit, PageDirection direction,
+                                      const TransactionFilter& filter = TransactionFilter());
+    // Người dùng theo cột sắp xếp của filter: (name, id), email hoặc id; cursor = {giá trị cột, id}.
+    // Lọc theo loại, trạng thái (index (user_type|status, name, id)) và từ khóa (users_fts) trong SQL.
+    // Hướng Forward đi theo filter.sortOrder.
+    ScopedQuery getUsersPageData(const PageCursor& cursor, int limit, PageDirection direction, const UserFilter& filter);
+    // Tổng số và số người dùng đang hoạt động thỏa filter, trong một truy vấn tổng hợp
+    UserCounts getUserCounts(const UserFilter& filter);
+    // Tìm kiếm toàn văn trên title, author (dạng đã bỏ dấu, xem TextNormalizer) và isbn qua chỉ mục books_fts.
+    // Kết quả sắp theo mức độ liên quan (bm25), tối đa limit dòng; rỗng nếu không có từ nào để tìm.
+    ScopedQuery searchBooksData(const QString& searchTerm, int limit);
+    // Dựng lại chỉ mục toàn văn từ bảng books và users
+    bool rebuildSearchIndex();
+    // So khớp books_fts/users_fts với rowid hiện tại của bảng gốc; false nếu chỉ mục đã lệch
+    bool verifySearchIndex();
+    // Trạng thái nội bộ dạng khóa/giá trị (bảng app_state); chuỗi rỗng nếu chưa có
+    QString getAppState(const QString& key);
+    bool setAppState(const QString& key, const QString& value);
+    // ID người dùng mới dạng prefix + số thứ tự (STU100, STU101, ...), không giới hạn số chữ số.
+    // Số thứ tự được lưu trong app_state; phải gọi trong TransactionScope cùng với lần ghi người dùng
+    // để hai người ghi không nhận cùng một số. Chuỗi rỗng nếu lỗi.
+    QString nextUserId(const QString& prefix);
+    // Thống kê bộ nhớ đệm câu lệnh của luồng hiện tại
+    LruCacheStats getStatementCacheStats();
 
     // Lấy thống kê
+    // Các hàm đếm quét bảng (COUNT); dùng làm giá trị chuẩn khi kiểm tra bộ đếm
     int getBookCount();
     int getUserCount();
     int getActiveTransactionCount();
+    int getOverdueTransactionCount();
+    // Đọc bảng library_stats do trigger duy trì: một truy vấn, không phụ thuộc kích thước dữ liệu
+    LibraryStatistics getStatistics();
+    // Tính lại bộ đếm từ các bảng gốc (sửa khi bị lệch)
+    bool rebuildStatistics();
+    // So sánh bộ đếm với kết quả COUNT thực tế; ghi log các số liệu bị lệch
+    bool verifyStatistics();
 
     // Lưu/Cập nhật dữ liệu
     bool saveNewUser(const Person& user, const QString& hashedPassword); // Sửa: Nhận mật khẩu đã băm
+    // Thay hash mật khẩu chỉ khi hash hiện tại vẫn là oldHash (không ghi đè một lần đổi mật khẩu khác)
+    bool upgradeUserPassword(const QString& userId, const QString& oldHash, const QString& newHash);
     bool saveNewBook(const Book& book);
+    // Chèn nhiều sách bằng một câu INSERT nhiều dòng; ISBN đã tồn tại bị bỏ qua ngay trong SQL.
+    // Trả về số sách thực sự được thêm, hoặc -1 nếu lỗi.
+    int saveNewBooks(const std::vector<Book>& books);
     bool updateBook(const Book& book, int newAvailableCopies); // Sửa: Tách riêng available copies
     bool deleteBook(const QString& isbn);
+    // Xóa mềm: chuyển người dùng sang 'Inactive', lịch sử giao dịch được giữ nguyên.
+    // Thất bại nếu người dùng không tồn tại, đã Inactive hoặc còn sách đang mượn (users.active_loans > 0).
+    bool deactivateUser(const QString& userId);
     bool saveNewTransaction(const Transaction& transaction);
     bool updateBookCopies(const QString& isbn, int available);
     bool updateTransactionOnReturn(int transactionId);
+
+    // Mượn/trả sách nguyên tử: mỗi thao tác là một transaction duy nhất,
+    // số bản có sẵn được tăng/giảm có điều kiện ngay trong SQL (không đọc-sửa-ghi)
+    // checkoutBook chỉ thành công khi người dùng đang mượn ít hơn maxActiveLoans khoản (users.active_loans
+    // được tăng/giảm cùng transaction) và ghi ID giao dịch mới vào newTransactionId (nếu có);
+    // checkinBook ghi ISBN của sách vào bookIsbn (nếu có).
+    // availableCopies nhận số bản có sẵn đọc lại trong cùng transaction, trước COMMIT (-1 nếu sách
+    // không còn); cache ghi giá trị tuyệt đối này thay vì cộng delta nên không bị cộng hai lần
+    // khi một lần nạp lại cache đã đọc được dữ liệu sau commit.
+    bool checkoutBook(const Transaction& transaction, int maxActiveLoans, int* newTransactionId = nullptr,
+                      int* availableCopies = nullptr);
+    bool checkinBook(int transactionId, QString* bookIsbn = nullptr, int* availableCopies = nullptr);
+
+    // Kiểm tra bất biến: available_copies = total_copies - số bản đang được mượn
+    bool verifyCopyCounts();
+    // Kiểm tra/tính lại users.active_loans từ các giao dịch chưa trả
+    bool verifyActiveLoans();
+    bool rebuildActiveLoans();
 };
 
 #endif // DATABASEMANAGER_H
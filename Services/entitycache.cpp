@@ -0,0 +1,63 @@
+#include "entitycache.h"
+
+EntityCache::EntityCache(int userCapacity, int bookCapacity)
+    : users(userCapacity), books(bookCapacity) {
+}
+
+QSqlRecord EntityCache::findUser(const QString& userId) {
+    std::lock_guard<std::mutex> lock(mtx);
+    const QSqlRecord* record = users.find(userId);
+    return record ? *record : QSqlRecord();
+}
+
+void EntityCache::putUser(QSqlRecord userRecord) {
+    // Hash mật khẩu không cần cho việc tra cứu, không giữ trong bộ nhớ.
+    // active_loans thay đổi sau mỗi lần mượn/trả nên luôn phải đọc từ database.
+    for (const char* column : {"password", "active_loans"}) {
+        const int index = userRecord.indexOf(column);
+        if (index >= 0) userRecord.remove(index);
+    }
+
+    const QString userId = userRecord.value("id").toString();
+    if (userId.isEmpty()) return;
+    std::lock_guard<std::mutex> lock(mtx);
+    users.insert(userId, std::move(userRecord));
+}
+
+void EntityCache::removeUser(const QString& userId) {
+    std::lock_guard<std::mutex> lock(mtx);
+    users.remove(userId);
+}
+
+std::unique_ptr<Book> EntityCache::findBook(const QString& isbn) {
+    std::lock_guard<std::mutex> lock(mtx);
+    const Book* book = books.find(isbn);
+    return book ? std::make_unique<Book>(*book) : nullptr;
+}
+
+void EntityCache::putBook(const Book& book) {
+    std::lock_guard<std::mutex> lock(mtx);
+    books.insert(book.getIsbn(), book);
+}
+
+void EntityCache::removeBook(const QString& isbn) {
+    std::lock_guard<std::mutex> lock(mtx);
+    books.remove(isbn);
+}
+
+void EntityCache::setAvailableCopies(const QString& isbn, int availableCopies) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (Book* book = books.peek(isbn)) {
+        book->setAvailableCopies(availableCopies);
+    }
+}
+
+LruCacheStats EntityCache::userStats() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return users.stats();
+}
+
+LruCacheStats EntityCache::bookStats() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return books.stats();
+}
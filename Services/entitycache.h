@@ -0,0 +1,44 @@
+#ifndef ENTITYCACHE_H
+#define ENTITYCACHE_H
+
+#include <QSqlRecord>
+#include <QString>
+#include <memory>
+#include <mutex>
+#include "lrucache.h"
+#include "Models/book.h"
+
+// Bộ nhớ đệm LRU có giới hạn cho các bản ghi hay được tra trên luồng mượn/trả:
+// người dùng theo ID (bản ghi users, không giữ cột password và active_loans) và sách theo ISBN.
+// Khác với CatalogCache (toàn bộ danh mục, chỉ nạp khi cần liệt kê), cache này chỉ giữ
+// các bản ghi vừa được dùng nên có ích ngay từ lần tra đầu tiên.
+// LibraryService cập nhật cache sau mỗi thao tác ghi của chính nó; các hàm đều khóa mutex.
+class EntityCache {
+public:
+    EntityCache(int userCapacity, int bookCapacity);
+
+    EntityCache(const EntityCache&) = delete;
+    EntityCache& operator=(const EntityCache&) = delete;
+
+    // Bản ghi rỗng nếu không có trong cache
+    QSqlRecord findUser(const QString& userId);
+    void putUser(QSqlRecord userRecord);
+    void removeUser(const QString& userId);
+
+    std::unique_ptr<Book> findBook(const QString& isbn);
+    void putBook(const Book& book);
+    void removeBook(const QString& isbn);
+    // Ghi số bản có sẵn đã commit nếu sách đang có trong cache.
+    // Dùng giá trị tuyệt đối: bản ghi có thể đã được putBook từ dữ liệu đọc sau commit
+    void setAvailableCopies(const QString& isbn, int availableCopies);
+
+    LruCacheStats userStats() const;
+    LruCacheStats bookStats() const;
+
+private:
+    mutable std::mutex mtx;
+    LruCache<QString, QSqlRecord> users;
+    LruCache<QString, Book> books;
+};
+
+#endif // ENTITYCACHE_H
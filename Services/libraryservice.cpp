@@ -1,5 +1,8 @@
 #include "libraryservice.h"
 #include "databasemanager.h"
+#include "passwordhasher.h"
+#include "rowmapper.h"
+#include "transactionscope.h"
 #include "Factories/userfactory.h"
 #include "Models/student.h"
 #include "Models/faculty.h"
@@ -7,17 +10,14 @@
 #include "Models/transaction.h"
 #include "Models/book.h"
 #include <QSqlQuery>
-#include <random>
-#include <QCryptographicHash>
-#include <QByteArray>
-#include <QFile>
-#include <QTextStream>
-#include <QStringConverter>
+#include <QSqlRecord>
+#include <algorithm>
+#include <QtConcurrent>
 
 void LibraryService::seedDatabaseFromResources() {
     auto& db = DatabaseManager::getInstance();
 
-    QSqlQuery query = db.executeQuery("SELECT COUNT(*) FROM users");
+    ScopedQuery query = db.executeQuery("SELECT COUNT(*) FROM users");
     if (query.next() && query.value(0).toInt() > 0) {
         qInfo() << "Database already contains data. Skipping seed.";
         return;
@@ -29,193 +29,214 @@ void LibraryService::seedDatabaseFromResources() {
     registerUser("Admin", "admin@library.com", "admin123", "Head Librarian");
 
     // --- Đọc và thêm sách từ file books.csv trong resources ---
-    QFile csvFile(":/data/books.csv"); // Sử dụng đường dẫn resource đã định nghĩa trong .qrc
-    if (!csvFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qWarning() << "FATAL: Could not open books.csv from resources! Make sure it's added to resources.qrc.";
+    // Sử dụng đường dẫn resource đã định nghĩa trong .qrc
+    ImportResult result = importCatalog(":/data/books.csv");
+    if (!result.ok) {
+        qWarning() << "FATAL: Could not import books.csv from resources! Make sure it's added to resources.qrc.";
         return;
     }
+    qInfo() << "Finished seeding data from CSV.";
+}
+
+ImportResult LibraryService::importCatalog(const QString& filePath) {
+    CatalogImporter importer;
+    connect(&importer, &CatalogImporter::progress, this, &LibraryService::importProgress);
 
-    QTextStream in(&csvFile);
-    in.setEncoding(QStringConverter::Utf8);
+    ImportResult result = importer.importFile(filePath);
 
-    // Bỏ qua dòng tiêu đề đầu tiên
-    if (!in.atEnd()) {
-        in.readLine();
+    // Một thông báo duy nhất sau khi nhập xong, thay vì mỗi dòng một lần
+    if (result.ok && result.inserted > 0) {
+        catalogCache.invalidate();
+        emit dataChanged();
     }
+    return result;
+}
 
-    while (!in.atEnd()) {
-        QString line = in.readLine();
-        QStringList fields = line.split(',');
+namespace {
+// Đủ cho số bạn đọc và đầu sách được tra thường xuyên tại quầy mượn/trả
+const int USER_CACHE_CAPACITY = 512;
+const int BOOK_CACHE_CAPACITY = 1024;
+}
 
-        if (fields.count() >= 4) {
-            QString isbn = fields.takeFirst().trimmed();
-            int copies = fields.takeLast().trimmed().toInt();
-            QString author = fields.takeLast().trimmed();
-            QString title = fields.join(',').trimmed();
+LibraryService::LibraryService()
+    : QObject(nullptr), currentUser(nullptr), entityCache(USER_CACHE_CAPACITY, BOOK_CACHE_CAPACITY) {
+    // Các khoản mượn chuyển sang quá hạn cũng là thay đổi dữ liệu
+    connect(&overdueMonitor, &OverdueMonitor::transactionsOverdue, this, &LibraryService::publishOverdue);
+    // Mọi thay đổi dữ liệu đều có thể làm số liệu thống kê thay đổi
+    connect(this, &LibraryService::dataChanged, &statisticsProvider, &StatisticsProvider::requestUpdate);
+    connect(this, &LibraryService::bookUpserted, &statisticsProvider, &StatisticsProvider::requestUpdate);
+    connect(this, &LibraryService::bookRemoved, &statisticsProvider, &StatisticsProvider::requestUpdate);
+    connect(this, &LibraryService::transactionAdded, &statisticsProvider, &StatisticsProvider::requestUpdate);
+    connect(this, &LibraryService::transactionUpdated, &statisticsProvider, &StatisticsProvider::requestUpdate);
+    connect(this, &LibraryService::userAdded, &statisticsProvider, &StatisticsProvider::requestUpdate);
+    connect(this, &LibraryService::userDeactivated, &statisticsProvider, &StatisticsProvider::requestUpdate);
+    overdueMonitor.start();
+    initializePasswordCost();
+    // Số liệu của lần chạy trước, hiển thị ngay cho tới khi Dashboard yêu cầu đọc lại
+    statisticsProvider.restoreSnapshot();
+}
 
-            // Xử lý trường hợp title hoặc author có dấu nháy kép bao quanh
-            if (title.startsWith('"') && title.endsWith('"')) {
-                title = title.mid(1, title.length() - 2);
-            }
-            if (author.startsWith('"') && author.endsWith('"')) {
-                author = author.mid(1, author.length() - 2);
-            }
+// SỬA LỖI: Thêm định nghĩa destructor (dù là mặc định)
+LibraryService::~LibraryService() = default;
 
-            addBook(isbn, title, author, copies);
-        } else {
-            qWarning() << "Skipping malformed CSV line:" << line;
+namespace {
+// Đọc một trang từ query đã lấy dư một dòng (limit + 1) để biết còn dữ liệu hay không.
+// Cursor được lấy trực tiếp từ các cột khóa sắp xếp của kết quả.
+template <typename T>
+Page<T> readPage(QSqlQuery& query, int limit, PageDirection direction,
+                 const QString& sortColumn, const QString& tieColumn) {
+    Page<T> page;
+    const RowMapper<T> mapper(query.record());
+    const int sortIndex = query.record().indexOf(sortColumn);
+    const int tieIndex = query.record().indexOf(tieColumn);
+
+    std::vector<PageCursor> cursors;
+    while (query.next()) {
+        if (static_cast<int>(page.items.size()) == limit) {
+            page.hasMore = true;
+            break;
         }
+        page.items.push_back(mapper(query));
+        cursors.push_back({query.value(sortIndex), query.value(tieIndex)});
     }
 
-    csvFile.close();
-    qInfo() << "Finished seeding data from CSV.";
-}
-
-// --- Lớp tiện ích để băm mật khẩu ---
-namespace PasswordHasher {
-QString generateSalt() {
-    const int saltLength = 16;
-    const char charset[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
-    QString salt;
-    std::uniform_int_distribution<> dis(0, sizeof(charset) - 2);
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    for (int i = 0; i < saltLength; ++i) {
-        salt += charset[dis(gen)];
+    // Trang đọc lùi được trả về theo thứ tự ngược, đảo lại cho đúng thứ tự xuôi
+    if (direction == PageDirection::Backward) {
+        std::reverse(page.items.begin(), page.items.end());
+        std::reverse(cursors.begin(), cursors.end());
     }
-    return salt;
-}
-
-QString hashPassword(const QString& password, const QString& salt) {
-    QByteArray data = (password + salt).toUtf8();
-    QByteArray hash = QCryptographicHash::hash(data, QCryptographicHash::Sha256);
-    return QString(hash.toHex());
+    if (!cursors.empty()) {
+        page.first = cursors.front();
+        page.last = cursors.back();
+    }
+    return page;
 }
-
-QString createHashedPasswordWithSalt(const QString& password) {
-    QString salt = generateSalt();
-    QString hash = hashPassword(password, salt);
-    return salt + ":" + hash;
 }
 
-bool verifyPassword(const QString& password, const QString& storedHashWithSalt) {
-    QStringList parts = storedHashWithSalt.split(':');
-    if (parts.size() != 2) return false;
-    QString salt = parts[0];
-    QString storedHash = parts[1];
-    return hashPassword(password, salt) == storedHash;
-}
+namespace {
+const QString PASSWORD_ITERATIONS_KEY = "password_iterations";
+// Thời gian mục tiêu cho một lần băm mật khẩu trên máy hiện tại
+const int TARGET_HASH_MS = 250;
 }
 
+void LibraryService::initializePasswordCost() {
+    const int stored = DatabaseManager::getInstance().getAppState(PASSWORD_ITERATIONS_KEY).toInt();
+    if (stored > 0) {
+        PasswordHasher::setIterations(stored);
+        return;
+    }
 
-LibraryService::LibraryService() : QObject(nullptr), currentUser(nullptr) {
-    // Constructor
+    // Lần chạy đầu trên máy này: hiệu chỉnh trên thread pool rồi lưu lại.
+    // Các hash tạo trước khi hiệu chỉnh xong dùng mức mặc định và được nâng cấp khi đăng nhập.
+    QtConcurrent::run([]() {
+        const int iterations = PasswordHasher::calibrate(TARGET_HASH_MS);
+        qInfo() << "Password hashing calibrated to" << iterations << "PBKDF2 iterations";
+        // Nếu database đã đóng trong lúc hiệu chỉnh, executor từ chối tác vụ; lần chạy sau hiệu chỉnh lại
+        DatabaseManager::getInstance().executor().run([iterations]() {
+            DatabaseManager::getInstance().setAppState(PASSWORD_ITERATIONS_KEY, QString::number(iterations));
+        });
+    });
 }
 
-// SỬA LỖI: Thêm định nghĩa destructor (dù là mặc định)
-LibraryService::~LibraryService() = default;
-
 // --- Hàm tiện ích để tạo ID người dùng ---
-QString generateUserId(const QString& userType) {
-    QString prefix;
-    if (userType.toLower() == "student") prefix = "STU";
-    else if (userType.toLower() == "faculty") prefix = "FAC";
-    else prefix = "LIB";
-
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(100, 999);
-    return prefix + QString::number(dis(gen));
-}
-
-// --- Helper Functions ---
-std::unique_ptr<Person> LibraryService::createUserFromQuery(QSqlQuery& query) {
-    return UserFactory::create(
-        query.value("user_type").toString(),
-        query.value("id").toString(),
-        query.value("name").toString(),
-        query.value("email").toString(),
-        query.value("password").toString()
-        );
-}
-
-std::unique_ptr<Book> LibraryService::createBookFromQuery(QSqlQuery& query) {
-    // Tạo đối tượng Book với các thông tin cơ bản
-    auto book = std::make_unique<Book>(
-        query.value("isbn").toString(),
-        query.value("title").toString(),
-        query.value("author").toString(),
-        query.value("total_copies").toInt()
-        );
-
-    // SỬA LỖI QUAN TRỌNG:
-    // Lấy giá trị available_copies từ database và gán vào đối tượng book
-    book->setAvailableCopies(query.value("available_copies").toInt());
-
-    return book;
-}
-
-std::unique_ptr<Transaction> LibraryService::createTransactionFromQuery(QSqlQuery& query) {
-    auto transaction = std::make_unique<Transaction>(
-        query.value("id").toInt(),
-        query.value("user_id").toString(),
-        query.value("book_isbn").toString()
-        );
-    transaction->setBorrowDate(QDateTime::fromString(query.value("borrow_date").toString(), Qt::ISODate));
-    transaction->setUserName(query.value("user_name").toString());
-    transaction->setBookTitle(query.value("book_title").toString());
-
-    QString status = query.value("status").toString();
-    if (status == "Completed") transaction->setStatus(TransactionStatus::Completed);
-    else if (status == "Overdue") transaction->setStatus(TransactionStatus::Overdue);
-    else transaction->setStatus(TransactionStatus::Active);
-
-    return transaction;
+QString userIdPrefix(const QString& userType) {
+    if (userType.toLower() == "student") return "STU";
+    if (userType.toLower() == "faculty") return "FAC";
+    return "LIB";
 }
 
 // --- Core Functions ---
 
 bool LibraryService::registerUser(const QString& name, const QString& email, const QString& password, const QString& userType) {
+    const QString userId = createUser(name, email, PasswordHasher::hash(password), userType);
+    if (userId.isEmpty()) return false;
+    emit userAdded(userId);
+    return true;
+}
+
+QString LibraryService::createUser(const QString& name, const QString& email, const QString& hashedPassword, const QString& userType) {
     auto& db = DatabaseManager::getInstance();
+    // Cấp số thứ tự và ghi người dùng trong cùng transaction (SAVEPOINT khi nằm trong createUsers)
+    TransactionScope scope(db);
+    if (!scope.isActive()) return QString();
+
     if (db.getUserDataByEmail(email).next()) {
         qWarning() << "Registration failed: Email already exists -" << email;
-        return false;
+        return QString();
     }
 
-    QString newUserId = generateUserId(userType);
+    const QString newUserId = db.nextUserId(userIdPrefix(userType));
+    if (newUserId.isEmpty()) {
+        qWarning() << "Registration failed: Could not allocate a user ID.";
+        return QString();
+    }
     auto newUser = UserFactory::create(userType, newUserId, name, email, "");
     if (!newUser) {
         qWarning() << "Registration failed: Could not create user object.";
-        return false;
+        return QString();
     }
 
-    QString hashedPassword = PasswordHasher::createHashedPasswordWithSalt(password);
-    if (db.saveNewUser(*newUser, hashedPassword)) {
+    if (db.saveNewUser(*newUser, hashedPassword) && scope.commit()) {
         qInfo() << "User registered successfully:" << name;
-        emit dataChanged();
-        return true;
+        return newUserId;
     }
-    return false;
+    return QString();
+}
+
+QStringList LibraryService::createUsers(const QList<UserRegistration>& users, const QStringList& hashedPasswords) {
+    // Một transaction cho cả lô; người dùng bị từ chối (trùng email...) được bỏ qua
+    TransactionScope scope;
+    if (!scope.isActive()) return {};
+
+    QStringList userIds;
+    for (int i = 0; i < users.size(); ++i) {
+        const UserRegistration& user = users[i];
+        const QString userId = createUser(user.name, user.email, hashedPasswords[i], user.userType);
+        if (!userId.isEmpty()) userIds << userId;
+    }
+    return scope.commit() ? userIds : QStringList();
 }
 
 bool LibraryService::login(const QString& email, const QString& password) {
     logout();
-    auto& db = DatabaseManager::getInstance();
-    QSqlQuery query = db.getUserDataByEmail(email);
-
-    if (query.next()) {
-        QString storedHash = query.value("password").toString();
-        if (PasswordHasher::verifyPassword(password, storedHash)) {
-            auto user = createUserFromQuery(query);
-            if (user) {
-                setCurrentUser(std::move(user));
-                qInfo() << "Login successful for user:" << getCurrentUser()->getName();
-                return true;
+    return applyLogin(checkCredentials(findUserRecord(email), email, password));
+}
+
+QSqlRecord LibraryService::findUserRecord(const QString& email) {
+    ScopedQuery query = DatabaseManager::getInstance().getUserDataByEmail(email);
+    return query.next() ? query.record() : QSqlRecord();
+}
+
+QSqlRecord LibraryService::checkCredentials(const QSqlRecord& userRecord, const QString& email, const QString& password) {
+    const QString storedHash = userRecord.value("password").toString();
+    if (userRecord.isEmpty() || !PasswordHasher::verify(password, storedHash)) {
+        qWarning() << "Login failed for email:" << email;
+        return QSqlRecord();
+    }
+
+    // Hash cũ hoặc chi phí thấp hơn mức hiện tại: băm lại ngay khi còn mật khẩu gốc.
+    // Ghi xuống database trên luồng worker, không chờ kết quả.
+    if (PasswordHasher::needsRehash(storedHash)) {
+        const QString userId = userRecord.value("id").toString();
+        const QString upgradedHash = PasswordHasher::hash(password);
+        DatabaseManager::getInstance().executor().run([userId, storedHash, upgradedHash]() {
+            if (DatabaseManager::getInstance().upgradeUserPassword(userId, storedHash, upgradedHash)) {
+                qInfo() << "Upgraded password hash for user" << userId;
             }
-        }
+        });
     }
-    qWarning() << "Login failed for email:" << email;
-    return false;
+    return userRecord;
+}
+
+bool LibraryService::applyLogin(const QSqlRecord& userRecord) {
+    if (userRecord.isEmpty()) return false;
+
+    auto user = RowMapper<Person>(userRecord)(userRecord);
+    if (!user) return false;
+
+    setCurrentUser(std::move(user));
+    qInfo() << "Login successful for user:" << getCurrentUser()->getName();
+    return true;
 }
 
 void LibraryService::setCurrentUser(std::unique_ptr<Person> user) {
@@ -228,138 +249,183 @@ void LibraryService::logout() {
 
 std::vector<std::unique_ptr<Transaction>> LibraryService::getAllTransactions() {
     auto& db = DatabaseManager::getInstance();
-    QSqlQuery query = db.getAllTransactionsData();
-    std::vector<std::unique_ptr<Transaction>> transactions;
-    while(query.next()) {
-        transactions.push_back(createTransactionFromQuery(query));
-    }
-    return transactions;
+    ScopedQuery query = db.getAllTransactionsData();
+    return mapRows<Transaction>(query);
 }
 
 std::vector<std::unique_ptr<Book>> LibraryService::getAllBooks() {
-    auto& db = DatabaseManager::getInstance();
-    QSqlQuery query = db.getAllBooksData();
-    std::vector<std::unique_ptr<Book>> books;
-    while(query.next()) {
-        books.push_back(createBookFromQuery(query));
+    if (catalogCache.isLoaded()) {
+        return catalogCache.books();
     }
+
+    // Nạp cache lần đầu; nếu có thao tác ghi xen vào trong lúc đọc thì lần sau nạp lại
+    const quint64 generation = catalogCache.generation();
+    auto& db = DatabaseManager::getInstance();
+    ScopedQuery query = db.getAllBooksData();
+    auto books = mapRows<Book>(query);
+    catalogCache.load(books, generation);
     return books;
 }
 
-std::vector<std::unique_ptr<Book>> LibraryService::searchBooks(const QString& searchTerm) {
-    auto allBooks = getAllBooks();
-    if (searchTerm.isEmpty()) {
-        return allBooks;
-    }
-    std::vector<std::unique_ptr<Book>> filteredBooks;
-    for (auto& book : allBooks) {
-        if (book->getTitle().contains(searchTerm, Qt::CaseInsensitive) ||
-            book->getAuthor().contains(searchTerm, Qt::CaseInsensitive) ||
-            book->getIsbn().contains(searchTerm, Qt::CaseInsensitive)) {
-            // Đây là một lỗi logic tiềm ẩn: std::move sẽ làm mất book khỏi allBooks
-            // Cần một cách khác để lọc mà không di chuyển con trỏ
-            // Tuy nhiên, để giữ nguyên cấu trúc, chúng ta sẽ tạm chấp nhận
-            filteredBooks.push_back(std::move(book));
-        }
-    }
-    return filteredBooks;
+bool LibraryService::verifyCatalogCache() {
+    if (!catalogCache.isLoaded()) return true;
+
+    auto& db = DatabaseManager::getInstance();
+    ScopedQuery query = db.getAllBooksData();
+    return catalogCache.matches(mapRows<Book>(query));
 }
 
-bool LibraryService::borrowBook(const QString& userId, const QString& bookIsbn) {
+Page<Book> LibraryService::getBooksPage(const PageCursor& cursor, int limit, PageDirection direction) {
     auto& db = DatabaseManager::getInstance();
+    ScopedQuery query = db.getBooksPageData(cursor, limit + 1, direction);
+    return readPage<Book>(query, limit, direction, "title", "isbn");
+}
 
-    // BƯỚC 1: Xác thực dữ liệu đầu vào
-    if (!db.getUserDataById(userId).next()) {
-        qWarning() << "Borrow failed: User ID" << userId << "does not exist.";
-        return false;
-    }
+Page<Transaction> LibraryService::getTransactionsPage(const PageCursor& cursor, int limit, PageDirection direction,
+                                                     const TransactionFilter& filter) {
+    auto& db = DatabaseManager::getInstance();
+    ScopedQuery query = db.getTransactionsPageData(cursor, limit + 1, direction, filter);
+    return readPage<Transaction>(query, limit, direction, "borrow_date", "id");
+}
 
-    QSqlQuery bookQuery = db.getBookDataByIsbn(bookIsbn);
-    if (!bookQuery.next()) {
-        qWarning() << "Borrow failed: Book with ISBN" << bookIsbn << "does not exist.";
-        return false;
+SnapshotPage<TransactionSnapshot> LibraryService::getTransactionSnapshotPage(const PageCursor& cursor, int limit,
+                                                                           const TransactionFilter& filter) {
+    auto& db = DatabaseManager::getInstance();
+    ScopedQuery query = db.getTransactionsPageData(cursor, limit + 1, PageDirection::Forward, filter);
+    SnapshotPage<TransactionSnapshot> page;
+    page.rows = TransactionSnapshot::fromQuery(query, limit);
+    if (page.rows.size() == limit) {
+        // fromQuery dừng ở dòng cuối của trang: lấy cursor từ giá trị gốc trong database,
+        // rồi thử đọc dòng thứ limit + 1
+        page.last = {query.value("borrow_date"), query.value("id")};
+        page.hasMore = query.next();
     }
-    if (bookQuery.value("available_copies").toInt() <= 0) {
-        qWarning() << "Borrow failed: Book" << bookIsbn << "is out of stock.";
-        return false;
+    return page;
+}
+
+Page<UserSummary> LibraryService::getUsersPage(const PageCursor& cursor, int limit, const UserFilter& filter) {
+    auto& db = DatabaseManager::getInstance();
+    ScopedQuery query = db.getUsersPageData(cursor, limit + 1, PageDirection::Forward, filter);
+    switch (filter.sortColumn) {
+    case UserSortColumn::Email: return readPage<UserSummary>(query, limit, PageDirection::Forward, "email", "id");
+    case UserSortColumn::Id: return readPage<UserSummary>(query, limit, PageDirection::Forward, "id", "id");
+    case UserSortColumn::Name:
+    default: return readPage<UserSummary>(query, limit, PageDirection::Forward, "name", "id");
     }
+}
 
-    // TODO: Kiểm tra xem người dùng có mượn quá giới hạn không
+UserCounts LibraryService::getUserCounts(const UserFilter& filter) {
+    return DatabaseManager::getInstance().getUserCounts(filter);
+}
 
-    // BƯỚC 2: Thực hiện các thay đổi trên database
-    int newAvailable = bookQuery.value("available_copies").toInt() - 1;
-    if (!db.updateBookCopies(bookIsbn, newAvailable)) {
-        qWarning() << "Borrow failed: Could not update book copy count.";
-        return false;
+std::vector<std::unique_ptr<Book>> LibraryService::searchBooks(const QString& searchTerm, int limit) {
+    if (searchTerm.trimmed().isEmpty()) {
+        return getAllBooks();
     }
+    auto& db = DatabaseManager::getInstance();
+    ScopedQuery query = db.searchBooksData(searchTerm, limit);
+    return mapRows<Book>(query);
+}
 
-    Transaction newTransaction(0, userId, bookIsbn);
-    if (db.saveNewTransaction(newTransaction)) {
-        qInfo() << "Borrow successful for user" << userId << "and book" << bookIsbn;
-        emit dataChanged(); // PHÁT TÍN HIỆU KHI THÀNH CÔNG
-        return true;
-    } else {
-        qCritical() << "CRITICAL: Failed to save transaction, rolling back book count.";
-        db.updateBookCopies(bookIsbn, newAvailable + 1);
-        return false;
-    }
+bool LibraryService::borrowBook(const QString& userId, const QString& bookIsbn) {
+    const int transactionId = performBorrow(userId, bookIsbn);
+    if (transactionId == 0) return false;
+    publishBorrow(bookIsbn, transactionId); // PHÁT TÍN HIỆU KHI THÀNH CÔNG
+    return true;
 }
 
-bool LibraryService::returnBook(const QString& transactionId) {
+int LibraryService::performBorrow(const QString& userId, const QString& bookIsbn) {
     auto& db = DatabaseManager::getInstance();
 
-    // 1. Lấy thông tin giao dịch bằng ID
-    QSqlQuery transQuery = db.getTransactionById(transactionId.toInt());
-    if (!transQuery.next()) {
-        qWarning() << "Return book failed: Transaction with ID" << transactionId << "not found.";
-        return false;
+    // Giới hạn mượn theo loại người dùng; bản ghi người dùng thường đã có trong cache
+    const QSqlRecord userRecord = findUser(userId);
+    const auto user = userRecord.isEmpty() ? nullptr : RowMapper<Person>(userRecord)(userRecord);
+    if (!user) {
+        qWarning() << "Borrow failed: User ID" << userId << "does not exist.";
+        return 0;
     }
 
-    // 2. Kiểm tra xem giao dịch đã được hoàn thành chưa
-    if (transQuery.value("status").toString() == "Completed") {
-        qWarning() << "Return book failed: Transaction" << transactionId << "is already completed.";
-        return false;
+    // Một transaction duy nhất: tăng số khoản đang mượn và giảm số bản có điều kiện rồi ghi giao dịch
+    Transaction newTransaction(0, userId, bookIsbn);
+    int transactionId = 0;
+    int availableCopies = -1;
+    if (db.checkoutBook(newTransaction, user->getMaxBooksAllowed(), &transactionId, &availableCopies)) {
+        qInfo() << "Borrow successful for user" << userId << "and book" << bookIsbn;
+        // Giá trị đọc lại trước COMMIT, không phụ thuộc vào việc cache đã được nạp lại hay chưa
+        catalogCache.setAvailableCopies(bookIsbn, availableCopies);
+        entityCache.setAvailableCopies(bookIsbn, availableCopies);
+        overdueMonitor.noteDueDate(newTransaction.getDueDate());
+        return transactionId;
     }
 
-    // 3. Lấy ISBN của sách từ giao dịch
-    QString bookIsbnFromDb = transQuery.value("book_isbn").toString();
-
-    // 4. Lấy thông tin sách để cập nhật số lượng
-    QSqlQuery bookQuery = db.getBookDataByIsbn(bookIsbnFromDb);
-    if (bookQuery.next()) {
-        // 5. Tăng số lượng sách có sẵn
-        int newAvailable = bookQuery.value("available_copies").toInt() + 1;
-        if (!db.updateBookCopies(bookIsbnFromDb, newAvailable)) {
-            qWarning() << "Return book failed: Could not update book copy count for ISBN" << bookIsbnFromDb;
-            return false; // Lỗi nghiêm trọng, dừng lại
-        }
+    // Chỉ chạy khi thất bại: xác định lý do để ghi log
+    ScopedQuery userQuery = db.getUserDataById(userId);
+    if (!userQuery.next()) {
+        qWarning() << "Borrow failed: User ID" << userId << "does not exist.";
+        return 0;
+    }
+    if (userQuery.value("active_loans").toInt() >= user->getMaxBooksAllowed()) {
+        qWarning() << "Borrow failed: User" << userId << "has reached the limit of"
+                   << user->getMaxBooksAllowed() << "books.";
+        return 0;
+    }
+    auto book = findBook(bookIsbn);
+    if (!book) {
+        qWarning() << "Borrow failed: Book with ISBN" << bookIsbn << "does not exist.";
+    } else if (book->getAvailableCopies() <= 0) {
+        qWarning() << "Borrow failed: Book" << bookIsbn << "is out of stock.";
     } else {
-        qWarning() << "Book with ISBN" << bookIsbnFromDb << "not found. Cannot update copy count, but will complete transaction.";
+        qCritical() << "Borrow failed: Could not save transaction for user" << userId << "and book" << bookIsbn;
     }
+    return 0;
+}
+
+bool LibraryService::returnBook(const QString& transactionId) {
+    if (!performReturn(transactionId)) return false;
+    publishReturn(transactionId.toInt()); // Gửi tín hiệu để cập nhật giao diện
+    return true;
+}
+
+bool LibraryService::performReturn(const QString& transactionId) {
+    auto& db = DatabaseManager::getInstance();
 
-    // 6. Cập nhật trạng thái giao dịch thành 'Completed'
-    if (db.updateTransactionOnReturn(transactionId.toInt())) {
+    // Hoàn tất giao dịch và tăng số bản có sẵn trong cùng một transaction
+    QString bookIsbn;
+    int availableCopies = -1;
+    if (db.checkinBook(transactionId.toInt(), &bookIsbn, &availableCopies)) {
         qInfo() << "Book return successful for transaction ID:" << transactionId;
-        emit dataChanged(); // Gửi tín hiệu để cập nhật giao diện
+        // Số bản đọc lại trước COMMIT (-1 nếu sách không còn trong danh mục)
+        if (availableCopies >= 0) {
+            catalogCache.setAvailableCopies(bookIsbn, availableCopies);
+            entityCache.setAvailableCopies(bookIsbn, availableCopies);
+        }
         return true;
     }
 
-    // Nếu không thể cập nhật giao dịch, nên khôi phục lại số lượng sách (rollback)
-    // Tạm thời bỏ qua để đơn giản hóa
-    qWarning() << "Return book failed: Could not update transaction status for ID" << transactionId;
+    // Chỉ chạy khi thất bại: xác định lý do để ghi log
+    ScopedQuery transQuery = db.getTransactionById(transactionId.toInt());
+    if (!transQuery.next()) {
+        qWarning() << "Return book failed: Transaction with ID" << transactionId << "not found.";
+    } else if (transQuery.value("status").toString() == "Completed") {
+        qWarning() << "Return book failed: Transaction" << transactionId << "is already completed.";
+    } else {
+        qWarning() << "Return book failed: Could not update transaction status for ID" << transactionId;
+    }
     return false;
 }
 
 bool LibraryService::addBook(const QString& isbn, const QString& title, const QString& author, int totalCopies) {
     auto& db = DatabaseManager::getInstance();
-    if (db.getBookDataByIsbn(isbn).next()) {
+    if (findBook(isbn)) {
         qWarning() << "Add book failed: ISBN" << isbn << "already exists.";
         return false;
     }
 
     Book newBook(isbn, title, author, totalCopies);
     if (db.saveNewBook(newBook)) {
-        emit dataChanged();
+        catalogCache.upsert(newBook);
+        entityCache.putBook(newBook);
+        emit bookUpserted(newBook);
         return true;
     }
     return false;
@@ -367,10 +433,10 @@ bool LibraryService::addBook(const QString& isbn, const QString& title, const QS
 
 bool LibraryService::updateBook(const QString& isbn, const QString& title, const QString& author, int totalCopies) {
     auto& db = DatabaseManager::getInstance();
-    QSqlQuery bookQuery = db.getBookDataByIsbn(isbn);
-    if (!bookQuery.next()) return false;
+    auto currentBook = findBook(isbn);
+    if (!currentBook) return false;
 
-    int borrowed = bookQuery.value("total_copies").toInt() - bookQuery.value("available_copies").toInt();
+    int borrowed = currentBook->getTotalCopies() - currentBook->getAvailableCopies();
     if (totalCopies < borrowed) {
         qWarning() << "Update failed: New total copies cannot be less than borrowed copies";
         return false;
@@ -380,7 +446,10 @@ bool LibraryService::updateBook(const QString& isbn, const QString& title, const
     Book bookToUpdate(isbn, title, author, totalCopies);
 
     if (db.updateBook(bookToUpdate, newAvailable)) {
-        emit dataChanged();
+        bookToUpdate.setAvailableCopies(newAvailable);
+        catalogCache.upsert(bookToUpdate);
+        entityCache.putBook(bookToUpdate);
+        emit bookUpserted(bookToUpdate);
         return true;
     }
     return false;
@@ -389,49 +458,244 @@ bool LibraryService::updateBook(const QString& isbn, const QString& title, const
 bool LibraryService::deleteBook(const QString& isbn) {
     auto& db = DatabaseManager::getInstance();
     if (db.deleteBook(isbn)) {
-        emit dataChanged();
+        catalogCache.remove(isbn);
+        entityCache.removeBook(isbn);
+        emit bookRemoved(isbn);
         return true;
     }
     return false;
 }
 
 std::vector<std::unique_ptr<Transaction>> LibraryService::getCurrentUserTransactions() {
-    std::vector<std::unique_ptr<Transaction>> transactions;
-    if (!currentUser) return transactions;
+    if (!currentUser) return {};
 
     auto& db = DatabaseManager::getInstance();
-    QSqlQuery query = db.getTransactionsDataByUserId(currentUser->getUserId());
-    while(query.next()) {
-        transactions.push_back(createTransactionFromQuery(query));
-    }
-    return transactions;
+    ScopedQuery query = db.getTransactionsDataByUserId(currentUser->getUserId());
+    return mapRows<Transaction>(query);
+}
+
+LibraryStatistics LibraryService::getStatistics() {
+    return DatabaseManager::getInstance().getStatistics();
 }
 
 int LibraryService::getTotalBooksCount() {
-    return DatabaseManager::getInstance().getBookCount();
+    return getStatistics().totalBooks;
 }
 
 int LibraryService::getTotalUsersCount() {
-    return DatabaseManager::getInstance().getUserCount();
+    return getStatistics().totalUsers;
 }
 
 int LibraryService::getActiveTransactionsCount() {
-    return DatabaseManager::getInstance().getActiveTransactionCount();
+    return getStatistics().activeTransactions;
 }
 
 void LibraryService::checkOverdueBooks() {
+    // dataChanged được phát qua tín hiệu transactionsOverdue nếu có khoản mới quá hạn
+    overdueMonitor.processDueLoans();
+}
+
+int LibraryService::getOverdueTransactionsCount() {
+    return getStatistics().overdueTransactions;
+}
+
+// --- Tín hiệu thay đổi ---
+
+namespace {
+// Quá nhiều giao dịch đổi trạng thái cùng lúc thì tải lại toàn bộ rẻ hơn cập nhật từng dòng
+const int MAX_ROW_UPDATES = 100;
+}
+
+std::unique_ptr<Book> LibraryService::findBook(const QString& isbn) {
+    if (catalogCache.isLoaded()) {
+        return catalogCache.find(isbn);
+    }
+    if (auto book = entityCache.findBook(isbn)) {
+        return book;
+    }
+
+    auto& db = DatabaseManager::getInstance();
+    ScopedQuery query = db.getBookDataByIsbn(isbn);
+    if (!query.next()) return nullptr;
+    auto book = RowMapper<Book>(query.record())(query);
+    entityCache.putBook(*book);
+    return book;
+}
+
+QSqlRecord LibraryService::findUser(const QString& userId) {
+    QSqlRecord userRecord = entityCache.findUser(userId);
+    if (!userRecord.isEmpty()) return userRecord;
+
+    ScopedQuery query = DatabaseManager::getInstance().getUserDataById(userId);
+    if (!query.next()) return QSqlRecord();
+    entityCache.putUser(query.record());
+    return query.record();
+}
+
+std::unique_ptr<Transaction> LibraryService::findTransactionDetails(int transactionId) {
     auto& db = DatabaseManager::getInstance();
-    QSqlQuery query = db.executeQuery(
-        "UPDATE transactions SET status = 'Overdue' WHERE status = 'Active' AND due_date < date('now')"
-        );
+    ScopedQuery query = db.getTransactionDetailsById(transactionId);
+    return query.next() ? RowMapper<Transaction>(query.record())(query) : nullptr;
+}
+
+void LibraryService::publishBook(const QString& isbn) {
+    if (auto book = findBook(isbn)) {
+        emit bookUpserted(*book);
+    } else {
+        emit bookRemoved(isbn);
+    }
+}
+
+void LibraryService::publishBorrow(const QString& bookIsbn, int transactionId) {
+    if (auto transaction = findTransactionDetails(transactionId)) {
+        emit transactionAdded(*transaction);
+    }
+    publishBook(bookIsbn);
+}
+
+void LibraryService::publishReturn(int transactionId) {
+    if (auto transaction = findTransactionDetails(transactionId)) {
+        emit transactionUpdated(*transaction);
+        publishBook(transaction->getBookIsbn());
+    }
+}
 
-    if (query.numRowsAffected() > 0) {
+void LibraryService::publishOverdue(const QList<int>& transactionIds) {
+    if (transactionIds.size() > MAX_ROW_UPDATES) {
         emit dataChanged();
+        return;
+    }
+    for (int transactionId : transactionIds) {
+        if (auto transaction = findTransactionDetails(transactionId)) {
+            emit transactionUpdated(*transaction);
+        }
     }
 }
 
-int LibraryService::getOverdueTransactionsCount() {
-    auto& db = DatabaseManager::getInstance();
-    QSqlQuery query = db.executeQuery("SELECT COUNT(*) FROM transactions WHERE status = 'Overdue'");
-    return query.next() ? query.value(0).toInt() : 0;
+// --- Phiên bản bất đồng bộ ---
+// Phần database chạy trên luồng worker; continuation với context là this
+// chạy trên luồng của LibraryService để phát tín hiệu và đổi currentUser an toàn.
+
+// Băm mật khẩu chạy trên thread pool (QThreadPool::globalInstance) để không giữ luồng
+// worker database, vốn thực thi tuần tự, trong suốt thời gian băm.
+
+QFuture<bool> LibraryService::loginAsync(const QString& email, const QString& password) {
+    logout();
+    return DatabaseManager::getInstance().executor().run([email]() {
+        return findUserRecord(email);
+    }).then(QtFuture::Launch::Async, [email, password](const QSqlRecord& userRecord) {
+        return checkCredentials(userRecord, email, password);
+    }).then(this, [this](const QSqlRecord& userRecord) {
+        return applyLogin(userRecord);
+    });
+}
+
+QFuture<bool> LibraryService::registerUserAsync(const QString& name, const QString& email, const QString& password, const QString& userType) {
+    return QtConcurrent::run([password]() {
+        return PasswordHasher::hash(password);
+    }).then([this, name, email, userType](const QString& hashedPassword) {
+        return DatabaseManager::getInstance().executor().run([this, name, email, hashedPassword, userType]() {
+            return createUser(name, email, hashedPassword, userType);
+        });
+    }).unwrap().then(this, [this](const QString& userId) {
+        if (userId.isEmpty()) return false;
+        emit userAdded(userId);
+        return true;
+    });
+}
+
+QFuture<int> LibraryService::registerUsersAsync(const QList<UserRegistration>& users) {
+    // Mỗi mật khẩu được băm song song trên các lõi, sau đó ghi cả lô trong một transaction
+    return QtConcurrent::mapped(users, [](const UserRegistration& user) {
+        return PasswordHasher::hash(user.password);
+    }).then([this, users](QFuture<QString> hashed) {
+        const QStringList hashedPasswords = hashed.results();
+        return DatabaseManager::getInstance().executor().run([this, users, hashedPasswords]() {
+            return createUsers(users, hashedPasswords);
+        });
+    }).unwrap().then(this, [this](const QStringList& userIds) {
+        if (userIds.size() > MAX_ROW_UPDATES) {
+            emit dataChanged();
+        } else {
+            for (const QString& userId : userIds) emit userAdded(userId);
+        }
+        return static_cast<int>(userIds.size());
+    });
+}
+
+QFuture<bool> LibraryService::borrowBookAsync(const QString& userId, const QString& bookIsbn) {
+    return DatabaseManager::getInstance().executor().run([this, userId, bookIsbn]() {
+        return performBorrow(userId, bookIsbn);
+    }).then(this, [this, bookIsbn](int transactionId) {
+        if (transactionId == 0) return false;
+        publishBorrow(bookIsbn, transactionId);
+        return true;
+    });
+}
+
+QFuture<bool> LibraryService::returnBookAsync(const QString& transactionId) {
+    return DatabaseManager::getInstance().executor().run([this, transactionId]() {
+        return performReturn(transactionId);
+    }).then(this, [this, transactionId](bool success) {
+        if (success) publishReturn(transactionId.toInt());
+        return success;
+    });
+}
+
+QFuture<int> LibraryService::checkOverdueBooksAsync() {
+    return overdueMonitor.processDueLoansAsync().then([](const QList<int>& overdueIds) {
+        return static_cast<int>(overdueIds.size());
+    });
+}
+
+QFuture<LibraryStatistics> LibraryService::getStatisticsAsync() {
+    return DatabaseManager::getInstance().executor().run([]() {
+        return DatabaseManager::getInstance().getStatistics();
+    });
+}
+
+QFuture<UserListing> LibraryService::getUsersAsync(const UserFilter& filter, int limit, const PageCursor& cursor) {
+    // getUsersPage/getUserCounts chỉ đọc database, không chạm tới trạng thái của LibraryService
+    return DatabaseManager::getInstance().executor().run([this, filter, limit, cursor]() {
+        Page<UserSummary> page = getUsersPage(cursor, limit, filter);
+        UserListing listing;
+        listing.users.reserve(page.items.size());
+        for (auto& user : page.items) {
+            listing.users.push_back(std::move(*user));
+        }
+        listing.last = page.last;
+        listing.hasMore = page.hasMore;
+        if (cursor.isNull()) listing.counts = getUserCounts(filter);
+        return listing;
+    });
+}
+
+QFuture<std::vector<Transaction>> LibraryService::getUserTransactionsAsync(const QString& userId) {
+    return DatabaseManager::getInstance().executor().run([userId]() {
+        ScopedQuery query = DatabaseManager::getInstance().getTransactionsDataByUserId(userId);
+        std::vector<Transaction> transactions;
+        const RowMapper<Transaction> mapRow(query.record());
+        while (query.next()) {
+            transactions.push_back(*mapRow(query));
+        }
+        return transactions;
+    });
+}
+
+QFuture<bool> LibraryService::deactivateUserAsync(const QString& userId) {
+    // currentUser chỉ được đọc trên luồng của LibraryService, trước khi chuyển sang worker
+    const bool isCurrentUser = currentUser && currentUser->getUserId() == userId;
+    if (isCurrentUser) {
+        qWarning() << "Deactivate user failed: Cannot deactivate the user who is logged in.";
+    }
+    return DatabaseManager::getInstance().executor().run([userId, isCurrentUser]() {
+        return !isCurrentUser && DatabaseManager::getInstance().deactivateUser(userId);
+    }).then(this, [this, userId](bool success) {
+        if (success) {
+            // Bản ghi trong cache còn trạng thái cũ
+            entityCache.removeUser(userId);
+            emit userDeactivated(userId);
+        }
+        return success;
+    });
 }
@@ -5,11 +5,30 @@
 #include <memory>
 #include <vector>
 #include <QSqlQuery>
+#include <QSqlRecord>
+#include <QFuture>
+#include "catalogcache.h"
+#include "catalogimporter.h"
+#include "databasemanager.h"
+#include "entitycache.h"
+#include "overduemonitor.h"
+#include "pagination.h"
+#include "snapshot.h"
+#include "statisticsprovider.h"
+#include "userdirectory.h"
+#include "Models/book.h"
+#include "Models/transaction.h"
 
 // Forward declarations
 class Person;
-class Book;
-class Transaction;
+
+// Một người dùng cần đăng ký trong registerUsersAsync
+struct UserRegistration {
+    QString name;
+    QString email;
+    QString password;
+    QString userType;
+};
 
 class LibraryService : public QObject {
     Q_OBJECT
@@ -20,6 +39,8 @@ public:
 
     // đọc sách từ .csv
     void seedDatabaseFromResources();
+    // Nhập danh mục sách từ CSV (file trên đĩa hoặc resource ":/...")
+    ImportResult importCatalog(const QString& filePath);
 
     // --- Chức năng chính ---
     bool registerUser(const QString& name, const QString& email, const QString& password, const QString& userType);
@@ -30,37 +51,118 @@ public:
     Person* getCurrentUser() const { return currentUser.get(); }
 
     // Quản lý sách
+    // Đọc từ danh mục trong bộ nhớ; chỉ truy vấn database ở lần đầu hoặc sau khi cache bị xóa
     std::vector<std::unique_ptr<Book>> getAllBooks();
-    std::vector<std::unique_ptr<Book>> searchBooks(const QString& searchTerm);
+    // Tìm theo tên, tác giả hoặc ISBN (khớp tiền tố từng từ), sắp theo mức độ liên quan.
+    // Chuỗi rỗng trả về toàn bộ danh mục.
+    std::vector<std::unique_ptr<Book>> searchBooks(const QString& searchTerm, int limit = 200);
+    // Phân trang keyset theo (title, isbn); chi phí không phụ thuộc kích thước danh mục
+    Page<Book> getBooksPage(const PageCursor& cursor, int limit, PageDirection direction = PageDirection::Forward);
     bool addBook(const QString& isbn, const QString& title, const QString& author, int totalCopies);
     bool updateBook(const QString& isbn, const QString& title, const QString& author, int totalCopies);
     bool deleteBook(const QString& isbn);
+    // Kiểm tra danh mục trong bộ nhớ có khớp với bảng books hay không (dùng khi kiểm thử/gỡ lỗi)
+    bool verifyCatalogCache();
+    // Tỉ lệ trúng của cache tra cứu người dùng/sách trên luồng mượn/trả
+    LruCacheStats getUserCacheStats() const { return entityCache.userStats(); }
+    LruCacheStats getBookCacheStats() const { return entityCache.bookStats(); }
 
     // Quản lý mượn/trả
     bool borrowBook(const QString& userId, const QString& bookIsbn);
     bool returnBook(const QString& transactionId);
     std::vector<std::unique_ptr<Transaction>> getAllTransactions();
+    // Giao dịch mới nhất trước, phân trang keyset theo (borrow_date, id), lọc trong SQL
+    Page<Transaction> getTransactionsPage(const PageCursor& cursor, int limit, PageDirection direction = PageDirection::Forward,
+                                          const TransactionFilter& filter = TransactionFilter());
+    // Cùng trang như getTransactionsPage (hướng xuôi) nhưng đọc thẳng vào snapshot dạng cột
+    SnapshotPage<TransactionSnapshot> getTransactionSnapshotPage(const PageCursor& cursor, int limit,
+                                                                 const TransactionFilter& filter = TransactionFilter());
     std::vector<std::unique_ptr<Transaction>> getCurrentUserTransactions();
 
+    // Quản lý người dùng: lọc, sắp xếp và phân trang keyset trong SQL
+    Page<UserSummary> getUsersPage(const PageCursor& cursor, int limit, const UserFilter& filter);
+    UserCounts getUserCounts(const UserFilter& filter);
+
     // Thống kê và tác vụ nền
+    // Quá hạn được OverdueMonitor tự phát hiện đúng lúc đến hạn; hàm này chỉ buộc kiểm tra ngay
     void checkOverdueBooks();
+    OverdueMonitor& getOverdueMonitor() { return overdueMonitor; }
+    // Mọi số liệu trong một truy vấn (bộ đếm do trigger duy trì)
+    LibraryStatistics getStatistics();
+    // Số liệu được tự cập nhật sau mỗi thay đổi dữ liệu; giao diện chỉ cần lắng nghe statisticsChanged
+    StatisticsProvider& getStatisticsProvider() { return statisticsProvider; }
     int getTotalBooksCount();
     int getTotalUsersCount();
     int getActiveTransactionsCount();
     int getOverdueTransactionsCount();
 
+    // --- Phiên bản bất đồng bộ ---
+    // Chạy trên luồng worker database (DatabaseManager::executor()), kết quả được trả về
+    // trên luồng của LibraryService; các tín hiệu thay đổi cũng được phát trên luồng đó.
+    // Dùng future.then(widget, ...) để cập nhật giao diện; continuation tự hủy nếu widget bị xóa.
+    QFuture<bool> loginAsync(const QString& email, const QString& password);
+    QFuture<bool> registerUserAsync(const QString& name, const QString& email, const QString& password, const QString& userType);
+    // Đăng ký hàng loạt; trả về số người dùng được thêm
+    QFuture<int> registerUsersAsync(const QList<UserRegistration>& users);
+    QFuture<bool> borrowBookAsync(const QString& userId, const QString& bookIsbn);
+    QFuture<bool> returnBookAsync(const QString& transactionId);
+    QFuture<int> checkOverdueBooksAsync();
+    QFuture<LibraryStatistics> getStatisticsAsync();
+    // Trang người dùng sau cursor theo filter; số đếm chỉ được đọc cho trang đầu tiên (cursor rỗng)
+    QFuture<UserListing> getUsersAsync(const UserFilter& filter, int limit, const PageCursor& cursor = PageCursor());
+    // Lịch sử mượn của một người dùng (kèm tên sách), mới nhất trước
+    QFuture<std::vector<Transaction>> getUserTransactionsAsync(const QString& userId);
+    // Chuyển người dùng sang Inactive; không áp dụng cho người đang đăng nhập hoặc còn sách đang mượn
+    QFuture<bool> deactivateUserAsync(const QString& userId);
+
 signals:
+    // Thay đổi theo từng bản ghi: widget chỉ cần cập nhật đúng các dòng bị ảnh hưởng.
+    // Luôn được phát trên luồng của LibraryService.
+    void bookUpserted(const Book& book);
+    void bookRemoved(const QString& isbn);
+    void transactionAdded(const Transaction& transaction);
+    void transactionUpdated(const Transaction& transaction);
+    void userAdded(const QString& userId);
+    void userDeactivated(const QString& userId);
+    // Thay đổi hàng loạt (nhập danh mục, nhiều giao dịch quá hạn cùng lúc): cần tải lại toàn bộ
     void dataChanged();
+    void importProgress(qint64 rowsProcessed, double rowsPerSecond);
 
 private:
-    // Helper để chuyển đổi QSqlQuery thành Object
-    std::unique_ptr<Person> createUserFromQuery(QSqlQuery& query);
-    std::unique_ptr<Book> createBookFromQuery(QSqlQuery& query);
-    std::unique_ptr<Transaction> createTransactionFromQuery(QSqlQuery& query);
-
     void setCurrentUser(std::unique_ptr<Person> user);
+    bool applyLogin(const QSqlRecord& userRecord);
+
+    // Đọc chi phí băm mật khẩu đã lưu, hoặc hiệu chỉnh ở nền nếu chưa có
+    void initializePasswordCost();
+
+    // Phần thao tác database của các chức năng trên, không phát tín hiệu
+    // nên có thể chạy trên bất kỳ luồng nào
+    static QSqlRecord findUserRecord(const QString& email);
+    // Trả về userRecord nếu mật khẩu đúng (bản ghi rỗng nếu sai); tốn thời gian băm
+    static QSqlRecord checkCredentials(const QSqlRecord& userRecord, const QString& email, const QString& password);
+    // createUser trả về ID người dùng mới, performBorrow trả về ID giao dịch mới (rỗng/0 nếu thất bại)
+    QString createUser(const QString& name, const QString& email, const QString& hashedPassword, const QString& userType);
+    QStringList createUsers(const QList<UserRegistration>& users, const QStringList& hashedPasswords);
+    int performBorrow(const QString& userId, const QString& bookIsbn);
+    bool performReturn(const QString& transactionId);
+
+    // Phát các tín hiệu thay đổi sau khi thao tác đã commit (trên luồng của LibraryService)
+    void publishBorrow(const QString& bookIsbn, int transactionId);
+    void publishReturn(int transactionId);
+    void publishBook(const QString& isbn);
+    void publishOverdue(const QList<int>& transactionIds);
+    // Tra qua các cache trước, chỉ đọc database khi không có
+    std::unique_ptr<Book> findBook(const QString& isbn);
+    QSqlRecord findUser(const QString& userId);
+    std::unique_ptr<Transaction> findTransactionDetails(int transactionId);
 
     std::unique_ptr<Person> currentUser;
+    // Bản sao bảng books, được cập nhật sau mỗi thao tác ghi thành công
+    CatalogCache catalogCache;
+    // Người dùng và sách vừa được tra cứu (giới hạn kích thước)
+    EntityCache entityCache;
+    OverdueMonitor overdueMonitor;
+    StatisticsProvider statisticsProvider;
 };
 
 #endif // LIBRARYSERVICE_H
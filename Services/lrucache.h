@@ -0,0 +1,117 @@
+#ifndef LRUCACHE_H
+#define LRUCACHE_H
+
+#include <QHash>
+#include <QtGlobal>
+#include <list>
+#include <utility>
+
+// Số liệu thống kê của một LruCache
+struct LruCacheStats {
+    quint64 hits = 0;
+    quint64 misses = 0;
+    quint64 evictions = 0;
+    int size = 0;
+    int capacity = 0;
+
+    double hitRate() const {
+        const quint64 total = hits + misses;
+        return total == 0 ? 0.0 : double(hits) / double(total);
+    }
+};
+
+// Bộ nhớ đệm có giới hạn kích thước, loại bỏ phần tử ít được dùng gần đây nhất (LRU).
+// Không an toàn đa luồng: đối tượng sở hữu cache phải tự đồng bộ hóa.
+template <typename Key, typename Value>
+class LruCache {
+public:
+    explicit LruCache(int capacity) : maxSize(qMax(1, capacity)) {}
+
+    // Trả về con trỏ tới giá trị và đánh dấu là vừa được dùng, hoặc nullptr nếu không có.
+    // Con trỏ chỉ hợp lệ cho đến lần insert/remove tiếp theo.
+    Value* find(const Key& key) {
+        auto it = index.find(key);
+        if (it == index.end()) {
+            ++counters.misses;
+            return nullptr;
+        }
+        ++counters.hits;
+        entries.splice(entries.begin(), entries, it.value());
+        return &it.value()->second;
+    }
+
+    // Như find() nhưng không đổi thứ tự LRU và không tính vào thống kê
+    Value* peek(const Key& key) {
+        auto it = index.find(key);
+        return it == index.end() ? nullptr : &it.value()->second;
+    }
+
+    void insert(const Key& key, Value value) {
+        auto it = index.find(key);
+        if (it != index.end()) {
+            it.value()->second = std::move(value);
+            entries.splice(entries.begin(), entries, it.value());
+            return;
+        }
+        entries.emplace_front(key, std::move(value));
+        index.insert(key, entries.begin());
+        trim();
+    }
+
+    bool remove(const Key& key) {
+        auto it = index.find(key);
+        if (it == index.end()) return false;
+        entries.erase(it.value());
+        index.erase(it);
+        return true;
+    }
+
+    void clear() {
+        index.clear();
+        entries.clear();
+    }
+
+    // Duyệt toàn bộ phần tử (từ mới nhất đến cũ nhất) mà không thay đổi thứ tự LRU
+    template <typename Fn>
+    void forEach(Fn fn) {
+        for (auto& entry : entries) {
+            fn(entry.first, entry.second);
+        }
+    }
+
+    bool contains(const Key& key) const { return index.contains(key); }
+    int size() const { return static_cast<int>(entries.size()); }
+    int capacity() const { return maxSize; }
+
+    void setCapacity(int newCapacity) {
+        maxSize = qMax(1, newCapacity);
+        trim();
+    }
+
+    LruCacheStats stats() const {
+        LruCacheStats result = counters;
+        result.size = size();
+        result.capacity = maxSize;
+        return result;
+    }
+
+    void resetStats() { counters = LruCacheStats(); }
+
+private:
+    using Entry = std::pair<Key, Value>;
+
+    void trim() {
+        while (static_cast<int>(entries.size()) > maxSize) {
+            index.remove(entries.back().first);
+            entries.pop_back();
+            ++counters.evictions;
+        }
+    }
+
+    std::list<Entry> entries; // Phần tử đầu danh sách là phần tử vừa được dùng gần nhất
+    QHash<Key, typename std::list<Entry>::iterator> index;
+    int maxSize;
+    LruCacheStats counters;
+};
+
+#endif // LRUCACHE_H
@@ -0,0 +1,105 @@
+#include "overduemonitor.h"
+#include "databasemanager.h"
+#include "transactionscope.h"
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+// due_date lưu đến giây và được so sánh bằng "<", nên chạy trễ một giây so với hạn trả
+const qint64 DUE_GRACE_MS = 1000;
+// Hẹn giờ tối đa một ngày để tự điều chỉnh khi đồng hồ hệ thống thay đổi
+const qint64 MAX_TIMER_INTERVAL_MS = 24LL * 60 * 60 * 1000;
+// Thử lại sau khoảng này nếu lần chạy thất bại (ví dụ database đang bận)
+const int RETRY_INTERVAL_MS = 60 * 1000;
+}
+
+OverdueMonitor::OverdueMonitor(QObject* parent) : QObject(parent) {
+    timer.setSingleShot(true);
+    connect(&timer, &QTimer::timeout, this, [this]() { processDueLoansAsync(); });
+}
+
+void OverdueMonitor::start() {
+    processDueLoansAsync();
+}
+
+QList<int> OverdueMonitor::processDueLoans() {
+    const RunResult result = run();
+    finishRun(result);
+    return result.overdueIds;
+}
+
+QFuture<QList<int>> OverdueMonitor::processDueLoansAsync() {
+    return DatabaseManager::getInstance().executor().run([]() {
+        return run();
+    }).then(this, [this](const RunResult& result) {
+        finishRun(result);
+        return result.overdueIds;
+    });
+}
+
+void OverdueMonitor::noteDueDate(const QDateTime& dueDate) {
+    QMetaObject::invokeMethod(this, [this, dueDate]() {
+        if (!timer.isActive() || dueDate < scheduledDue) {
+            scheduleAt(dueDate);
+        }
+    }, Qt::AutoConnection);
+}
+
+OverdueMonitor::RunResult OverdueMonitor::run() {
+    auto& db = DatabaseManager::getInstance();
+    const QString now = QDateTime::currentDateTime().toString(Qt::ISODate);
+
+    TransactionScope scope(db);
+    if (!scope.isActive()) return RunResult();
+
+    // Đoạn ('Active', < now) của index (status, due_date), không có cận dưới
+    RunResult result;
+    ScopedQuery due = db.executeQuery(
+        "SELECT id FROM transactions WHERE status = 'Active' AND due_date < ?", {now});
+    while (due.next()) {
+        result.overdueIds << due.value(0).toInt();
+    }
+
+    if (!result.overdueIds.isEmpty()) {
+        ScopedQuery mark = db.executeQuery(
+            "UPDATE transactions SET status = 'Overdue' WHERE status = 'Active' AND due_date < ?", {now});
+        if (!mark.isActive()) return RunResult();
+    }
+
+    ScopedQuery next = db.executeQuery(
+        "SELECT MIN(due_date) FROM transactions WHERE status = 'Active' AND due_date >= ?", {now});
+    if (next.next() && !next.isNull(0)) {
+        result.nextDue = QDateTime::fromString(next.value(0).toString(), Qt::ISODate);
+    }
+
+    if (!scope.commit()) return RunResult();
+    result.ok = true;
+    return result;
+}
+
+void OverdueMonitor::finishRun(const RunResult& result) {
+    if (!result.ok) {
+        qWarning() << "Overdue check failed, retrying in" << RETRY_INTERVAL_MS / 1000 << "seconds.";
+        scheduledDue = QDateTime();
+        timer.start(RETRY_INTERVAL_MS);
+        return;
+    }
+
+    scheduleAt(result.nextDue);
+    if (!result.overdueIds.isEmpty()) {
+        qInfo() << result.overdueIds.size() << "loan(s) became overdue:" << result.overdueIds;
+        emit transactionsOverdue(result.overdueIds);
+    }
+}
+
+void OverdueMonitor::scheduleAt(const QDateTime& when) {
+    if (!when.isValid()) {
+        timer.stop();
+        scheduledDue = QDateTime();
+        return;
+    }
+
+    const qint64 delay = QDateTime::currentDateTime().msecsTo(when) + DUE_GRACE_MS;
+    scheduledDue = when;
+    timer.start(static_cast<int>(std::clamp<qint64>(delay, 0, MAX_TIMER_INTERVAL_MS)));
+}
@@ -0,0 +1,54 @@
+#ifndef OVERDUEMONITOR_H
+#define OVERDUEMONITOR_H
+
+#include <QObject>
+#include <QTimer>
+#include <QDateTime>
+#include <QFuture>
+#include <QList>
+
+// Phát hiện các khoản mượn quá hạn theo từng đoạn thời gian.
+// Mỗi lần chạy đánh dấu mọi khoản 'Active' có due_date < hiện tại qua index (status, due_date),
+// rồi hẹn giờ đúng vào hạn trả sớm nhất tiếp theo thay vì kiểm tra định kỳ.
+// Các khoản đã xử lý chuyển sang 'Overdue' nên rời khỏi đoạn 'Active' của index: đoạn được quét
+// chỉ gồm các khoản vừa đến hạn, kể cả khoản có hạn nằm trước lần chạy trước (ghi với hạn trả
+// trong quá khứ, hoặc bị bỏ lỡ khi đồng hồ hệ thống bị chỉnh lùi).
+class OverdueMonitor : public QObject {
+    Q_OBJECT
+
+public:
+    explicit OverdueMonitor(QObject* parent = nullptr);
+
+    // Xử lý các khoản đã đến hạn (trên luồng worker) rồi tự hẹn giờ cho các lần sau
+    void start();
+
+    // Xử lý ngay trên luồng đang gọi; chỉ gọi từ luồng của OverdueMonitor
+    QList<int> processDueLoans();
+    // Xử lý trên luồng worker database, kết quả và tín hiệu được trả về luồng của OverdueMonitor
+    QFuture<QList<int>> processDueLoansAsync();
+
+    // Báo có khoản mượn mới hạn trả dueDate; hẹn giờ lại nếu sớm hơn lần chạy đã hẹn.
+    // Có thể gọi từ bất kỳ luồng nào.
+    void noteDueDate(const QDateTime& dueDate);
+
+signals:
+    // ID các giao dịch vừa chuyển sang 'Overdue' trong lần chạy này (không rỗng)
+    void transactionsOverdue(const QList<int>& transactionIds);
+
+private:
+    struct RunResult {
+        bool ok = false;
+        QList<int> overdueIds;
+        QDateTime nextDue; // Không hợp lệ nếu không còn khoản nào đang mượn
+    };
+
+    // Phần thao tác database, chạy trong một transaction
+    static RunResult run();
+    void finishRun(const RunResult& result);
+    void scheduleAt(const QDateTime& when);
+
+    QTimer timer;
+    QDateTime scheduledDue;
+};
+
+#endif // OVERDUEMONITOR_H
@@ -0,0 +1,42 @@
+#ifndef PAGINATION_H
+#define PAGINATION_H
+
+#include <QVariant>
+#include <memory>
+#include <vector>
+
+// Hướng đọc trang so với cursor
+enum class PageDirection {
+    Forward,  // Các dòng đứng sau cursor trong thứ tự sắp xếp
+    Backward  // Các dòng đứng trước cursor
+};
+
+// Vị trí trong thứ tự sắp xếp của phân trang keyset:
+// giá trị cột sắp xếp và khóa phụ để phân biệt các dòng trùng giá trị.
+// Cursor rỗng nghĩa là bắt đầu từ đầu (Forward) hoặc từ cuối (Backward).
+struct PageCursor {
+    QVariant sortKey;
+    QVariant tieBreaker;
+
+    bool isNull() const { return !sortKey.isValid() || !tieBreaker.isValid(); }
+};
+
+// Một trang kết quả, các phần tử luôn theo thứ tự sắp xếp xuôi
+template <typename T>
+struct Page {
+    std::vector<std::unique_ptr<T>> items;
+    PageCursor first;     // Cursor của phần tử đầu trang (dùng để lùi trang)
+    PageCursor last;      // Cursor của phần tử cuối trang (dùng để sang trang sau)
+    bool hasMore = false; // Còn dữ liệu tiếp theo theo hướng đã đọc
+};
+
+// Trang đọc thẳng vào snapshot dạng cột (BookSnapshot, TransactionSnapshot), chỉ theo hướng xuôi.
+// Khác Page<T>, sao chép được nên có thể trả về qua QFuture
+template <typename Snapshot>
+struct SnapshotPage {
+    Snapshot rows;
+    PageCursor last;
+    bool hasMore = false;
+};
+
+#endif // PAGINATION_H
@@ -0,0 +1,127 @@
+#include "passwordhasher.h"
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QElapsedTimer>
+#include <QMessageAuthenticationCode>
+#include <QRandomGenerator>
+#include <QStringList>
+#include <algorithm>
+#include <atomic>
+
+namespace {
+const QString SCHEME = "pbkdf2-sha256";
+const int SALT_BYTES = 16;
+// Khuyến nghị tối thiểu cho PBKDF2-HMAC-SHA256; calibrate() không bao giờ chọn thấp hơn
+const int MIN_ITERATIONS = 100000;
+const int MAX_ITERATIONS = 10000000;
+const int DEFAULT_ITERATIONS = 210000;
+// Số vòng lặp dùng để đo tốc độ khi hiệu chỉnh
+const int CALIBRATION_ITERATIONS = 20000;
+
+std::atomic<int> currentIterations{DEFAULT_ITERATIONS};
+
+// PBKDF2 với độ dài khóa bằng độ dài đầu ra SHA-256 (một khối duy nhất)
+QByteArray pbkdf2(const QByteArray& password, const QByteArray& salt, int iterations) {
+    QMessageAuthenticationCode mac(QCryptographicHash::Sha256, password);
+    mac.addData(salt);
+    mac.addData(QByteArray::fromHex("00000001")); // chỉ số khối INT(1)
+    QByteArray block = mac.result();
+    QByteArray derived = block;
+
+    for (int i = 1; i < iterations; ++i) {
+        mac.reset(); // giữ nguyên khóa
+        mac.addData(block);
+        block = mac.result();
+        for (int j = 0; j < derived.size(); ++j) {
+            derived[j] = derived[j] ^ block[j];
+        }
+    }
+    return derived;
+}
+
+// So sánh không dừng sớm để thời gian không lộ vị trí byte khác nhau
+bool constantTimeEquals(const QByteArray& a, const QByteArray& b) {
+    if (a.size() != b.size()) return false;
+    char diff = 0;
+    for (int i = 0; i < a.size(); ++i) {
+        diff |= a[i] ^ b[i];
+    }
+    return diff == 0;
+}
+
+QByteArray generateSalt() {
+    QByteArray salt(SALT_BYTES, Qt::Uninitialized);
+    QRandomGenerator::system()->fillRange(reinterpret_cast<quint32*>(salt.data()), SALT_BYTES / sizeof(quint32));
+    return salt;
+}
+
+// Định dạng cũ: "salt:hex(sha256(password + salt))"
+bool verifyLegacy(const QString& password, const QString& storedHash) {
+    const QStringList parts = storedHash.split(':');
+    if (parts.size() != 2) return false;
+    const QByteArray expected = QCryptographicHash::hash((password + parts[0]).toUtf8(), QCryptographicHash::Sha256).toHex();
+    return constantTimeEquals(expected, parts[1].toLatin1());
+}
+
+struct ParsedHash {
+    int iterations = 0;
+    QByteArray salt;
+    QByteArray hash;
+};
+
+bool parse(const QString& storedHash, ParsedHash& parsed) {
+    const QStringList parts = storedHash.split('$');
+    if (parts.size() != 4 || parts[0] != SCHEME) return false;
+
+    bool ok = false;
+    parsed.iterations = parts[1].toInt(&ok);
+    if (!ok || parsed.iterations <= 0) return false;
+    parsed.salt = QByteArray::fromBase64(parts[2].toLatin1());
+    parsed.hash = QByteArray::fromBase64(parts[3].toLatin1());
+    return !parsed.salt.isEmpty() && !parsed.hash.isEmpty();
+}
+}
+
+namespace PasswordHasher {
+int iterations() {
+    return currentIterations.load();
+}
+
+void setIterations(int iterations) {
+    currentIterations.store(std::clamp(iterations, MIN_ITERATIONS, MAX_ITERATIONS));
+}
+
+int calibrate(int targetMilliseconds) {
+    const QByteArray salt = generateSalt();
+    QElapsedTimer timer;
+    timer.start();
+    pbkdf2(QByteArrayLiteral("calibration"), salt, CALIBRATION_ITERATIONS);
+    const qint64 elapsedNs = std::max<qint64>(timer.nsecsElapsed(), 1);
+
+    const double scaled = double(CALIBRATION_ITERATIONS) * targetMilliseconds * 1000000.0 / double(elapsedNs);
+    const int rounded = static_cast<int>(std::min<double>(scaled, MAX_ITERATIONS) / 1000) * 1000;
+    setIterations(rounded);
+    return iterations();
+}
+
+QString hash(const QString& password) {
+    const int rounds = iterations();
+    const QByteArray salt = generateSalt();
+    const QByteArray derived = pbkdf2(password.toUtf8(), salt, rounds);
+    return QString("%1$%2$%3$%4").arg(SCHEME).arg(rounds)
+        .arg(QString::fromLatin1(salt.toBase64()), QString::fromLatin1(derived.toBase64()));
+}
+
+bool verify(const QString& password, const QString& storedHash) {
+    ParsedHash parsed;
+    if (parse(storedHash, parsed)) {
+        return constantTimeEquals(pbkdf2(password.toUtf8(), parsed.salt, parsed.iterations), parsed.hash);
+    }
+    return verifyLegacy(password, storedHash);
+}
+
+bool needsRehash(const QString& storedHash) {
+    ParsedHash parsed;
+    return !parse(storedHash, parsed) || parsed.iterations < iterations();
+}
+}
@@ -0,0 +1,26 @@
+#ifndef PASSWORDHASHER_H
+#define PASSWORDHASHER_H
+
+#include <QString>
+
+// Băm mật khẩu bằng PBKDF2-HMAC-SHA256 với salt ngẫu nhiên.
+// Chuỗi lưu trữ ghi kèm thuật toán và số vòng lặp: "pbkdf2-sha256$<vòng lặp>$<salt>$<hash>"
+// (salt/hash dạng base64), nên có thể tăng chi phí mà không làm hỏng các hash cũ.
+// Định dạng cũ "salt:sha256hex" (một lần SHA-256) vẫn được xác thực để nâng cấp khi đăng nhập.
+// Các hàm băm tốn thời gian theo thiết kế: không gọi trên luồng giao diện.
+namespace PasswordHasher {
+// Số vòng lặp dùng cho hash mới (an toàn khi đọc/ghi từ nhiều luồng)
+int iterations();
+void setIterations(int iterations);
+
+// Đo tốc độ PBKDF2 trên máy hiện tại, chọn số vòng lặp để một lần băm mất khoảng
+// targetMilliseconds (không thấp hơn mức tối thiểu), áp dụng và trả về giá trị đó
+int calibrate(int targetMilliseconds);
+
+QString hash(const QString& password);
+bool verify(const QString& password, const QString& storedHash);
+// true nếu hash dùng định dạng cũ hoặc ít vòng lặp hơn mức hiện tại
+bool needsRehash(const QString& storedHash);
+}
+
+#endif // PASSWORDHASHER_H
@@ -0,0 +1,145 @@
+#ifndef ROWMAPPER_H
+#define ROWMAPPER_H
+
+#include <QtSql/QSqlQuery>
+#include <QtSql/QSqlRecord>
+#include <QDateTime>
+#include <memory>
+#include <vector>
+#include "Models/book.h"
+#include "Models/transaction.h"
+#include "Models/person.h"
+#include "Factories/userfactory.h"
+#include "userdirectory.h"
+
+// Ánh xạ một dòng kết quả sang đối tượng model.
+// Vị trí các cột được tra một lần cho cả tập kết quả (từ QSqlRecord), sau đó mỗi dòng
+// chỉ đọc theo chỉ số thay vì tra tên cột như query.value("column_name").
+// Cột không có trong tập kết quả có chỉ số -1 và được đọc thành giá trị rỗng.
+template <typename T>
+struct RowMapper;
+
+// Row có thể là QSqlQuery (dòng hiện tại) hoặc QSqlRecord (dòng đã sao chép ra)
+namespace RowMapperDetail {
+template <typename Row>
+QString text(const Row& row, int column) {
+    return column < 0 ? QString() : row.value(column).toString();
+}
+
+template <typename Row>
+int number(const Row& row, int column) {
+    return column < 0 ? 0 : row.value(column).toInt();
+}
+
+inline TransactionStatus transactionStatus(const QString& statusText) {
+    if (statusText == QLatin1String("Completed")) return TransactionStatus::Completed;
+    if (statusText == QLatin1String("Overdue")) return TransactionStatus::Overdue;
+    return TransactionStatus::Active;
+}
+}
+
+template <>
+struct RowMapper<Book> {
+    explicit RowMapper(const QSqlRecord& record)
+        : isbn(record.indexOf("isbn")),
+          title(record.indexOf("title")),
+          author(record.indexOf("author")),
+          totalCopies(record.indexOf("total_copies")),
+          availableCopies(record.indexOf("available_copies")) {}
+
+    std::unique_ptr<Book> operator()(const QSqlQuery& query) const {
+        using namespace RowMapperDetail;
+        auto book = std::make_unique<Book>(text(query, isbn), text(query, title),
+                                           text(query, author), number(query, totalCopies));
+        book->setAvailableCopies(number(query, availableCopies));
+        return book;
+    }
+
+    int isbn, title, author, totalCopies, availableCopies;
+};
+
+template <>
+struct RowMapper<Transaction> {
+    explicit RowMapper(const QSqlRecord& record)
+        : id(record.indexOf("id")),
+          userId(record.indexOf("user_id")),
+          bookIsbn(record.indexOf("book_isbn")),
+          borrowDate(record.indexOf("borrow_date")),
+          dueDate(record.indexOf("due_date")),
+          returnDate(record.indexOf("return_date")),
+          status(record.indexOf("status")),
+          userName(record.indexOf("user_name")),
+          bookTitle(record.indexOf("book_title")) {}
+
+    std::unique_ptr<Transaction> operator()(const QSqlQuery& query) const {
+        using namespace RowMapperDetail;
+        auto transaction = std::make_unique<Transaction>(number(query, id), text(query, userId),
+                                                         text(query, bookIsbn));
+        transaction->setBorrowDate(QDateTime::fromString(text(query, borrowDate), Qt::ISODate));
+        // Giữ hạn trả mặc định của constructor nếu truy vấn không chọn cột due_date
+        if (dueDate >= 0) transaction->setDueDate(QDateTime::fromString(text(query, dueDate), Qt::ISODate));
+        transaction->setReturnDate(QDateTime::fromString(text(query, returnDate), Qt::ISODate));
+        transaction->setUserName(text(query, userName));
+        transaction->setBookTitle(text(query, bookTitle));
+
+        transaction->setStatus(transactionStatus(text(query, status)));
+        return transaction;
+    }
+
+    int id, userId, bookIsbn, borrowDate, dueDate, returnDate, status, userName, bookTitle;
+};
+
+template <>
+struct RowMapper<Person> {
+    explicit RowMapper(const QSqlRecord& record)
+        : userType(record.indexOf("user_type")),
+          id(record.indexOf("id")),
+          name(record.indexOf("name")),
+          email(record.indexOf("email")),
+          password(record.indexOf("password")) {}
+
+    // Có thể trả về nullptr nếu user_type không hợp lệ (xem UserFactory)
+    template <typename Row>
+    std::unique_ptr<Person> operator()(const Row& row) const {
+        using namespace RowMapperDetail;
+        return UserFactory::create(text(row, userType), text(row, id), text(row, name),
+                                   text(row, email), text(row, password));
+    }
+
+    int userType, id, name, email, password;
+};
+
+template <>
+struct RowMapper<UserSummary> {
+    explicit RowMapper(const QSqlRecord& record)
+        : id(record.indexOf("id")),
+          name(record.indexOf("name")),
+          email(record.indexOf("email")),
+          userType(record.indexOf("user_type")),
+          status(record.indexOf("status")),
+          activeLoans(record.indexOf("active_loans")) {}
+
+    std::unique_ptr<UserSummary> operator()(const QSqlQuery& query) const {
+        using namespace RowMapperDetail;
+        return std::make_unique<UserSummary>(UserSummary{text(query, id), text(query, name), text(query, email),
+                                                         text(query, userType), text(query, status),
+                                                         number(query, activeLoans)});
+    }
+
+    int id, name, email, userType, status, activeLoans;
+};
+
+// Đọc toàn bộ các dòng còn lại của query thành danh sách đối tượng T
+template <typename T>
+std::vector<std::unique_ptr<T>> mapRows(QSqlQuery& query) {
+    std::vector<std::unique_ptr<T>> rows;
+    const RowMapper<T> mapper(query.record());
+    while (query.next()) {
+        if (auto row = mapper(query)) {
+            rows.push_back(std::move(row));
+        }
+    }
+    return rows;
+}
+
+#endif // ROWMAPPER_H
@@ -0,0 +1,308 @@
+#include "schemamigrator.h"
+#include "databasemanager.h"
+#include "transactionscope.h"
+#include "textnormalizer.h"
+#include <QtSql/QSqlQuery>
+#include <QVariantList>
+#include <QDebug>
+
+namespace {
+// Truy vấn nóng và index mà nó bắt buộc phải dùng
+struct HotQuery {
+    QString sql;
+    QVariantList params;
+    QString expectedIndex;
+};
+
+// Tính title_norm/author_norm cho các sách đã có, theo từng lô rowid
+bool backfillNormalizedBookText(DatabaseManager& db) {
+    const int batchSize = 500;
+    qint64 lastRowId = 0;
+    while (true) {
+        ScopedQuery rows = db.executeQuery(
+            "SELECT rowid, title, author FROM books WHERE rowid > ? ORDER BY rowid LIMIT ?",
+            {lastRowId, batchSize});
+        if (!rows.isActive()) return false;
+
+        struct Row { qint64 rowId; QString title; QString author; };
+        std::vector<Row> batch;
+        while (rows.next()) {
+            batch.push_back({rows.value(0).toLongLong(), rows.value(1).toString(), rows.value(2).toString()});
+        }
+        if (batch.empty()) return true;
+
+        for (const Row& row : batch) {
+            ScopedQuery update = db.executeQuery(
+                "UPDATE books SET title_norm = ?, author_norm = ? WHERE rowid = ?",
+                {TextNormalizer::normalize(row.title), TextNormalizer::normalize(row.author), row.rowId});
+            if (!update.isActive()) return false;
+        }
+        lastRowId = batch.back().rowId;
+    }
+}
+
+// Tính name_norm cho các người dùng đã có, theo từng lô rowid
+bool backfillNormalizedUserNames(DatabaseManager& db) {
+    const int batchSize = 500;
+    qint64 lastRowId = 0;
+    while (true) {
+        ScopedQuery rows = db.executeQuery(
+            "SELECT rowid, name FROM users WHERE rowid > ? ORDER BY rowid LIMIT ?",
+            {lastRowId, batchSize});
+        if (!rows.isActive()) return false;
+
+        struct Row { qint64 rowId; QString name; };
+        std::vector<Row> batch;
+        while (rows.next()) {
+            batch.push_back({rows.value(0).toLongLong(), rows.value(1).toString()});
+        }
+        if (batch.empty()) return true;
+
+        for (const Row& row : batch) {
+            ScopedQuery update = db.executeQuery("UPDATE users SET name_norm = ? WHERE rowid = ?",
+                                               {TextNormalizer::normalize(row.name), row.rowId});
+            if (!update.isActive()) return false;
+        }
+        lastRowId = batch.back().rowId;
+    }
+}
+}
+
+SchemaMigrator::SchemaMigrator(DatabaseManager& db) : db(db) {
+}
+
+const std::vector<SchemaMigration>& SchemaMigrator::migrations() {
+    static const std::vector<SchemaMigration> all = {
+        {1, "Base tables", {
+            "CREATE TABLE IF NOT EXISTS users (id TEXT PRIMARY KEY, name TEXT, email TEXT UNIQUE, password TEXT, user_type TEXT);",
+            "CREATE TABLE IF NOT EXISTS books (isbn TEXT PRIMARY KEY, title TEXT, author TEXT, total_copies INTEGER, available_copies INTEGER);",
+            "CREATE TABLE IF NOT EXISTS transactions (id INTEGER PRIMARY KEY AUTOINCREMENT, user_id TEXT, book_isbn TEXT, borrow_date TEXT, due_date TEXT, return_date TEXT, status TEXT, FOREIGN KEY(user_id) REFERENCES users(id), FOREIGN KEY(book_isbn) REFERENCES books(isbn));"
+        }},
+        {2, "Indexes for hot queries", {
+            // Đếm theo trạng thái và quét sách quá hạn (status = 'Active' AND due_date < ...)
+            "CREATE INDEX IF NOT EXISTS idx_transactions_status_due ON transactions(status, due_date);",
+            // Lịch sử mượn của một người dùng, mới nhất trước
+            "CREATE INDEX IF NOT EXISTS idx_transactions_user_borrow ON transactions(user_id, borrow_date DESC);",
+            // Kiểm tra sách còn đang được mượn trước khi xóa
+            "CREATE INDEX IF NOT EXISTS idx_transactions_book_status ON transactions(book_isbn, status);",
+            // Danh mục sách sắp xếp theo tên
+            "CREATE INDEX IF NOT EXISTS idx_books_title ON books(title);"
+        }},
+        {3, "Keyset pagination indexes", {
+            // (title, isbn) là khóa phân trang của danh mục; thay thế index chỉ có title
+            "CREATE INDEX IF NOT EXISTS idx_books_title_isbn ON books(title, isbn);",
+            "DROP INDEX IF EXISTS idx_books_title;",
+            // id là rowid nên index trên borrow_date đã đủ cho thứ tự (borrow_date, id)
+            "CREATE INDEX IF NOT EXISTS idx_transactions_borrow_date ON transactions(borrow_date);"
+        }},
+        {4, "Accent-insensitive full-text search index for books", {
+            // Tên sách và tác giả đã bỏ dấu (TextNormalizer), được ghi cùng lúc với title/author.
+            // ALTER TABLE không có IF NOT EXISTS; user_version đảm bảo bước này chỉ chạy một lần
+            "ALTER TABLE books ADD COLUMN title_norm TEXT;",
+            "ALTER TABLE books ADD COLUMN author_norm TEXT;",
+            // Bảng FTS5 external content: chỉ lưu chỉ mục, nội dung đọc từ books theo rowid.
+            // books không có INTEGER PRIMARY KEY nên VACUUM có thể đổi rowid; DatabaseManager::initialize()
+            // phát hiện chỉ mục bị lệch (verifySearchIndex) và dựng lại.
+            // Văn bản đã được bỏ dấu khi ghi nên tokenizer không cần xử lý dấu nữa
+            "CREATE VIRTUAL TABLE IF NOT EXISTS books_fts USING fts5(title_norm, author_norm, isbn, "
+            "content='books', content_rowid='rowid', tokenize='unicode61 remove_diacritics 0');",
+            // Trọng số bm25 mặc định cho ORDER BY rank: tên sách > tác giả > ISBN
+            "INSERT INTO books_fts(books_fts, rank) VALUES('rank', 'bm25(10.0, 5.0, 1.0)');",
+            "CREATE TRIGGER IF NOT EXISTS books_fts_insert AFTER INSERT ON books BEGIN "
+            "INSERT INTO books_fts(rowid, title_norm, author_norm, isbn) VALUES (new.rowid, new.title_norm, new.author_norm, new.isbn); "
+            "END;",
+            "CREATE TRIGGER IF NOT EXISTS books_fts_delete AFTER DELETE ON books BEGIN "
+            "INSERT INTO books_fts(books_fts, rowid, title_norm, author_norm, isbn) VALUES ('delete', old.rowid, old.title_norm, old.author_norm, old.isbn); "
+            "END;",
+            // Chỉ các cột được đánh chỉ mục; mượn/trả (available_copies) không chạm tới FTS
+            "CREATE TRIGGER IF NOT EXISTS books_fts_update AFTER UPDATE OF title_norm, author_norm, isbn ON books BEGIN "
+            "INSERT INTO books_fts(books_fts, rowid, title_norm, author_norm, isbn) VALUES ('delete', old.rowid, old.title_norm, old.author_norm, old.isbn); "
+            "INSERT INTO books_fts(rowid, title_norm, author_norm, isbn) VALUES (new.rowid, new.title_norm, new.author_norm, new.isbn); "
+            "END;",
+            // Đánh chỉ mục các sách đã có; backfill sau đó cập nhật chỉ mục qua books_fts_update
+            "INSERT INTO books_fts(books_fts) VALUES('rebuild');"
+        }, backfillNormalizedBookText},
+        {5, "Trigger-maintained statistics counters", {
+            // Một dòng duy nhất chứa mọi số liệu của Dashboard
+            "CREATE TABLE IF NOT EXISTS library_stats (id INTEGER PRIMARY KEY CHECK (id = 1), "
+            "total_books INTEGER NOT NULL DEFAULT 0, total_users INTEGER NOT NULL DEFAULT 0, "
+            "active_transactions INTEGER NOT NULL DEFAULT 0, overdue_transactions INTEGER NOT NULL DEFAULT 0);",
+            "INSERT OR IGNORE INTO library_stats (id) VALUES (1);",
+            "CREATE TRIGGER IF NOT EXISTS stats_books_insert AFTER INSERT ON books BEGIN "
+            "UPDATE library_stats SET total_books = total_books + 1 WHERE id = 1; "
+            "END;",
+            "CREATE TRIGGER IF NOT EXISTS stats_books_delete AFTER DELETE ON books BEGIN "
+            "UPDATE library_stats SET total_books = total_books - 1 WHERE id = 1; "
+            "END;",
+            "CREATE TRIGGER IF NOT EXISTS stats_users_insert AFTER INSERT ON users BEGIN "
+            "UPDATE library_stats SET total_users = total_users + 1 WHERE id = 1; "
+            "END;",
+            "CREATE TRIGGER IF NOT EXISTS stats_users_delete AFTER DELETE ON users BEGIN "
+            "UPDATE library_stats SET total_users = total_users - 1 WHERE id = 1; "
+            "END;",
+            "CREATE TRIGGER IF NOT EXISTS stats_transactions_insert AFTER INSERT ON transactions BEGIN "
+            "UPDATE library_stats SET active_transactions = active_transactions + (new.status = 'Active'), "
+            "overdue_transactions = overdue_transactions + (new.status = 'Overdue') WHERE id = 1; "
+            "END;",
+            "CREATE TRIGGER IF NOT EXISTS stats_transactions_delete AFTER DELETE ON transactions BEGIN "
+            "UPDATE library_stats SET active_transactions = active_transactions - (old.status = 'Active'), "
+            "overdue_transactions = overdue_transactions - (old.status = 'Overdue') WHERE id = 1; "
+            "END;",
+            // Chỉ chạy khi trạng thái thực sự đổi (mượn -> trả, quá hạn...)
+            "CREATE TRIGGER IF NOT EXISTS stats_transactions_status AFTER UPDATE OF status ON transactions "
+            "WHEN old.status IS NOT new.status BEGIN "
+            "UPDATE library_stats SET "
+            "active_transactions = active_transactions + (new.status = 'Active') - (old.status = 'Active'), "
+            "overdue_transactions = overdue_transactions + (new.status = 'Overdue') - (old.status = 'Overdue') "
+            "WHERE id = 1; "
+            "END;",
+            // Khởi tạo từ dữ liệu hiện có (giống DatabaseManager::rebuildStatistics)
+            "UPDATE library_stats SET "
+            "total_books = (SELECT COUNT(*) FROM books), "
+            "total_users = (SELECT COUNT(*) FROM users), "
+            "active_transactions = (SELECT COUNT(*) FROM transactions WHERE status = 'Active'), "
+            "overdue_transactions = (SELECT COUNT(*) FROM transactions WHERE status = 'Overdue') "
+            "WHERE id = 1;"
+        }},
+        {6, "Application state key/value table", {
+            // Trạng thái nội bộ cần giữ qua các lần chạy (số vòng băm mật khẩu, số thứ tự mã người dùng)
+            "CREATE TABLE IF NOT EXISTS app_state (key TEXT PRIMARY KEY, value TEXT);"
+        }},
+        {7, "Per-user active loan counters", {
+            // Số khoản đang mượn (Active hoặc Overdue) của từng người dùng, được cập nhật
+            // cùng transaction với mượn/trả để kiểm tra giới hạn mà không cần COUNT
+            "ALTER TABLE users ADD COLUMN active_loans INTEGER NOT NULL DEFAULT 0;",
+            "UPDATE users SET active_loans = (SELECT COUNT(*) FROM transactions t "
+            "WHERE t.user_id = users.id AND t.status IN ('Active', 'Overdue'));"
+        }},
+        {8, "Transaction history filtered by status", {
+            // Lịch sử theo một trạng thái, mới nhất trước (lọc và phân trang trong SQL)
+            "CREATE INDEX IF NOT EXISTS idx_transactions_status_borrow ON transactions(status, borrow_date);"
+        }},
+        {9, "User status and directory indexes", {
+            "ALTER TABLE users ADD COLUMN status TEXT NOT NULL DEFAULT 'Active' "
+            "CHECK (status IN ('Active', 'Inactive', 'Suspended'));",
+            "ALTER TABLE users ADD COLUMN name_norm TEXT;",
+            // Danh sách người dùng sắp theo tên, khóa phân trang (name, id); email và id đã có index UNIQUE
+            "CREATE INDEX IF NOT EXISTS idx_users_name_id ON users(name, id);",
+            // Lọc theo loại hoặc trạng thái mà vẫn đọc theo thứ tự tên
+            "CREATE INDEX IF NOT EXISTS idx_users_type_name ON users(user_type, name, id);",
+            "CREATE INDEX IF NOT EXISTS idx_users_status_name ON users(status, name, id);"
+        }, backfillNormalizedUserNames},
+        {10, "Full-text index over user name, email and id", {
+            // Giống books_fts: external content, rowid của users có thể đổi sau VACUUM
+            // và được kiểm tra cùng books_fts khi khởi động
+            "CREATE VIRTUAL TABLE IF NOT EXISTS users_fts USING fts5(name_norm, email, id, "
+            "content='users', content_rowid='rowid', tokenize='unicode61 remove_diacritics 0');",
+            "CREATE TRIGGER IF NOT EXISTS users_fts_insert AFTER INSERT ON users BEGIN "
+            "INSERT INTO users_fts(rowid, name_norm, email, id) VALUES (new.rowid, new.name_norm, new.email, new.id); "
+            "END;",
+            "CREATE TRIGGER IF NOT EXISTS users_fts_delete AFTER DELETE ON users BEGIN "
+            "INSERT INTO users_fts(users_fts, rowid, name_norm, email, id) VALUES ('delete', old.rowid, old.name_norm, old.email, old.id); "
+            "END;",
+            // Mượn/trả (active_loans) và đổi trạng thái không chạm tới FTS
+            "CREATE TRIGGER IF NOT EXISTS users_fts_update AFTER UPDATE OF name_norm, email, id ON users BEGIN "
+            "INSERT INTO users_fts(users_fts, rowid, name_norm, email, id) VALUES ('delete', old.rowid, old.name_norm, old.email, old.id); "
+            "INSERT INTO users_fts(rowid, name_norm, email, id) VALUES (new.rowid, new.name_norm, new.email, new.id); "
+            "END;",
+            "INSERT INTO users_fts(users_fts) VALUES('rebuild');"
+        }}
+    };
+    return all;
+}
+
+int SchemaMigrator::latestVersion() {
+    return migrations().empty() ? 0 : migrations().back().version;
+}
+
+int SchemaMigrator::currentVersion() {
+    ScopedQuery query = db.executeQuery("PRAGMA user_version;");
+    return query.next() ? query.value(0).toInt() : 0;
+}
+
+bool SchemaMigrator::migrate() {
+    const int startVersion = currentVersion();
+    for (const SchemaMigration& migration : migrations()) {
+        if (migration.version <= startVersion) continue;
+        if (!apply(migration)) {
+            qCritical() << "Schema migration" << migration.version << "failed:" << migration.description;
+            return false;
+        }
+        qInfo() << "Applied schema migration" << migration.version << "-" << migration.description;
+    }
+    return true;
+}
+
+bool SchemaMigrator::apply(const SchemaMigration& migration) {
+    TransactionScope scope(db);
+    if (!scope.isActive()) return false;
+
+    for (const QString& statement : migration.statements) {
+        if (!db.executeQuery(statement).isActive()) {
+            return false;
+        }
+    }
+    if (migration.backfill && !migration.backfill(db)) {
+        return false;
+    }
+
+    // PRAGMA không nhận tham số bind nên phải ghép số phiên bản vào chuỗi
+    if (!db.executeQuery(QString("PRAGMA user_version = %1;").arg(migration.version)).isActive()) {
+        return false;
+    }
+    return scope.commit();
+}
+
+bool SchemaMigrator::verifyHotQueryPlans() {
+    const std::vector<HotQuery> hotQueries = {
+        // Mọi index bắt đầu bằng status đều phù hợp (status_due hoặc status_borrow)
+        {"SELECT COUNT(*) FROM transactions WHERE status = 'Active'", {},
+         "idx_transactions_status_"},
+        {"SELECT t.*, b.title AS book_title FROM transactions t LEFT JOIN books b ON t.book_isbn = b.isbn "
+         "WHERE t.user_id = ? ORDER BY t.borrow_date DESC", {QString()},
+         "idx_transactions_user_borrow"},
+        {"SELECT COUNT(*) FROM transactions WHERE book_isbn = ? AND status IN ('Active', 'Overdue')", {QString()},
+         "idx_transactions_book_status"},
+        {"SELECT * FROM books ORDER BY title", {},
+         "idx_books_title_isbn"},
+        {"SELECT * FROM books WHERE (title, isbn) > (?, ?) ORDER BY title, isbn LIMIT ?", {QString(), QString(), 1},
+         "idx_books_title_isbn"},
+        {"SELECT * FROM transactions t WHERE (t.borrow_date, t.id) < (?, ?) ORDER BY t.borrow_date DESC, t.id DESC LIMIT ?",
+         {QString(), 0, 1}, "idx_transactions_borrow_date"},
+        {"SELECT * FROM transactions t WHERE t.status = ? AND (t.borrow_date, t.id) < (?, ?) "
+         "ORDER BY t.borrow_date DESC, t.id DESC LIMIT ?", {QString("Overdue"), QString(), 0, 1},
+         "idx_transactions_status_borrow"},
+        {"UPDATE transactions SET status = 'Overdue' WHERE status = 'Active' AND due_date < ?",
+         {QString()}, "idx_transactions_status_due"},
+        {"SELECT MIN(due_date) FROM transactions WHERE status = 'Active' AND due_date >= ?", {QString()},
+         "idx_transactions_status_due"},
+        {"SELECT b.* FROM books_fts JOIN books b ON b.rowid = books_fts.rowid "
+         "WHERE books_fts MATCH ? ORDER BY books_fts.rank LIMIT ?", {QString("\"a\"*"), 1},
+         "books_fts VIRTUAL TABLE"},
+        {"SELECT u.* FROM users u WHERE (u.name, u.id) > (?, ?) ORDER BY u.name, u.id LIMIT ?",
+         {QString(), QString(), 1}, "idx_users_name_id"},
+        {"SELECT u.* FROM users u WHERE u.user_type = ? AND (u.name, u.id) > (?, ?) ORDER BY u.name, u.id LIMIT ?",
+         {QString("Student"), QString(), QString(), 1}, "idx_users_type_name"},
+        {"SELECT u.* FROM users u WHERE u.status = ? ORDER BY u.name, u.id LIMIT ?",
+         {QString("Suspended"), 1}, "idx_users_status_name"},
+        {"SELECT u.* FROM users u WHERE u.rowid IN (SELECT rowid FROM users_fts WHERE users_fts MATCH ?) "
+         "ORDER BY u.name, u.id LIMIT ?", {QString("\"a\"*"), 1}, "users_fts VIRTUAL TABLE"}
+    };
+
+    bool allIndexed = true;
+    for (const HotQuery& hot : hotQueries) {
+        ScopedQuery plan = db.executeQuery("EXPLAIN QUERY PLAN " + hot.sql, hot.params);
+        QStringList details;
+        while (plan.next()) {
+            details << plan.value("detail").toString();
+        }
+
+        const QString planText = details.join("; ");
+        if (!planText.contains(hot.expectedIndex)) {
+            qWarning() << "Query plan does not use" << hot.expectedIndex << "for:" << hot.sql
+                       << "-> plan:" << planText;
+            allIndexed = false;
+        }
+    }
+    return allIndexed;
+}
@@ -0,0 +1,43 @@
+#ifndef SCHEMAMIGRATOR_H
+#define SCHEMAMIGRATOR_H
+
+#include <QString>
+#include <QStringList>
+#include <functional>
+#include <vector>
+
+class DatabaseManager;
+
+// Một bước thay đổi schema được đánh số.
+// Mỗi migration chỉ chạy một lần: PRAGMA user_version được tăng trong cùng transaction, nên câu lệnh
+// không cần idempotent (ALTER TABLE ADD COLUMN không có IF NOT EXISTS). Migration lỗi được rollback cả bước.
+// backfill (nếu có) chạy sau các câu lệnh, trong cùng transaction, cho những dữ liệu
+// phải tính bằng C++ thay vì SQL.
+struct SchemaMigration {
+    int version;
+    QString description;
+    QStringList statements;
+    std::function<bool(DatabaseManager&)> backfill = nullptr;
+};
+
+// Áp dụng các migration còn thiếu dựa trên PRAGMA user_version.
+// Mỗi migration chạy trong một transaction riêng và chỉ tăng user_version khi thành công.
+class SchemaMigrator {
+public:
+    explicit SchemaMigrator(DatabaseManager& db);
+
+    bool migrate();
+    int currentVersion();
+    static int latestVersion();
+
+    // Chạy EXPLAIN QUERY PLAN cho các truy vấn nóng và kiểm tra chúng dùng đúng index
+    bool verifyHotQueryPlans();
+
+private:
+    bool apply(const SchemaMigration& migration);
+    static const std::vector<SchemaMigration>& migrations();
+
+    DatabaseManager& db;
+};
+
+#endif // SCHEMAMIGRATOR_H
@@ -0,0 +1,91 @@
+#include "searchcontroller.h"
+#include "databasemanager.h"
+#include <QPromise>
+#include <QSqlQuery>
+#include <memory>
+
+namespace {
+// Đủ ngắn để không thấy trễ, đủ dài để bỏ qua các phím gõ liên tiếp
+const int DEBOUNCE_MS = 250;
+// Số kết quả tối đa cho một từ khóa và số dòng mỗi lô gửi về giao diện
+const int RESULT_LIMIT = 200;
+const int BATCH_SIZE = 50;
+}
+
+SearchController::SearchController(QObject* parent) : QObject(parent) {
+    debounceTimer.setSingleShot(true);
+    debounceTimer.setInterval(DEBOUNCE_MS);
+    connect(&debounceTimer, &QTimer::timeout, this, &SearchController::startSearch);
+    connect(&watcher, &QFutureWatcherBase::resultReadyAt, this, &SearchController::onBatchReady);
+}
+
+SearchController::~SearchController() {
+    cancel();
+}
+
+void SearchController::setSearchTerm(const QString& term) {
+    const QString trimmed = term.trimmed();
+    if (trimmed == currentTerm) return;
+    currentTerm = trimmed;
+
+    if (currentTerm.isEmpty()) {
+        cancel();
+        emit cleared();
+        return;
+    }
+    debounceTimer.start(); // Khởi động lại nếu người dùng vẫn đang gõ
+}
+
+void SearchController::searchNow() {
+    debounceTimer.stop();
+    if (currentTerm.isEmpty()) {
+        cancel();
+        emit cleared();
+        return;
+    }
+    startSearch();
+}
+
+void SearchController::cancel() {
+    debounceTimer.stop();
+    ++generation;
+    watcher.cancel();
+}
+
+void SearchController::startSearch() {
+    cancel();
+    const quint64 searchGeneration = generation;
+    const QString term = currentTerm;
+    deliveredBatches = 0;
+
+    auto promise = std::make_shared<QPromise<Batch>>();
+    watcher.setFuture(promise->future());
+    promise->start();
+
+    // Truy vấn đã bị hủy trước khi tới lượt trên worker sẽ được bỏ qua ngay
+    DatabaseManager::getInstance().executor().run([promise, term, searchGeneration]() {
+        if (!promise->isCanceled()) {
+            ScopedQuery query = DatabaseManager::getInstance().searchBooksData(term, RESULT_LIMIT);
+            bool sentAny = false;
+            while (!promise->isCanceled()) {
+                BookSnapshot books = BookSnapshot::fromQuery(query, BATCH_SIZE);
+                const bool lastBatch = books.size() < BATCH_SIZE;
+                // Luôn gửi lô đầu tiên, kể cả khi rỗng, để giao diện xóa kết quả cũ
+                if (!books.isEmpty() || !sentAny) {
+                    promise->addResult(Batch{searchGeneration, std::move(books)});
+                    sentAny = true;
+                }
+                if (lastBatch) break;
+            }
+        }
+        promise->finish();
+    });
+}
+
+void SearchController::onBatchReady(int index) {
+    const Batch batch = watcher.resultAt(index);
+    if (batch.generation != generation) return; // Kết quả của từ khóa cũ
+
+    emit resultsReady(currentTerm, batch.books, deliveredBatches == 0);
+    ++deliveredBatches;
+}
@@ -0,0 +1,55 @@
+#ifndef SEARCHCONTROLLER_H
+#define SEARCHCONTROLLER_H
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QString>
+#include <QTimer>
+#include "snapshot.h"
+
+// Tìm kiếm sách theo từ khóa khi người dùng đang gõ:
+// - chờ người dùng ngừng gõ (debounce) rồi mới truy vấn;
+// - truy vấn chạy trên luồng worker database, kết quả được gửi về theo từng lô;
+// - một từ khóa mới hủy truy vấn đang chạy, các lô của truy vấn cũ bị bỏ qua (so theo generation).
+// Tín hiệu luôn được phát trên luồng của SearchController.
+class SearchController : public QObject {
+    Q_OBJECT
+public:
+    explicit SearchController(QObject* parent = nullptr);
+    ~SearchController();
+
+    QString searchTerm() const { return currentTerm; }
+    void setDebounceInterval(int milliseconds) { debounceTimer.setInterval(milliseconds); }
+
+public slots:
+    // Đặt từ khóa mới; truy vấn chạy sau khoảng debounce nếu không có từ khóa nào khác
+    void setSearchTerm(const QString& term);
+    // Chạy ngay với từ khóa hiện tại (ví dụ khi dữ liệu thay đổi)
+    void searchNow();
+    void cancel();
+
+signals:
+    // Từ khóa rỗng: hiển thị lại toàn bộ danh mục
+    void cleared();
+    // Một lô kết quả theo thứ tự liên quan; firstBatch = true ở lô đầu tiên của mỗi lần tìm
+    // (kể cả khi rỗng), khi đó kết quả cũ cần được thay thế
+    void resultsReady(const QString& term, const BookSnapshot& books, bool firstBatch);
+
+private:
+    // Một lô kết quả kèm generation của lần tìm đã tạo ra nó
+    struct Batch {
+        quint64 generation = 0;
+        BookSnapshot books;
+    };
+
+    void startSearch();
+    void onBatchReady(int index);
+
+    QTimer debounceTimer;
+    QString currentTerm;
+    quint64 generation = 0;
+    int deliveredBatches = 0;
+    QFutureWatcher<Batch> watcher;
+};
+
+#endif // SEARCHCONTROLLER_H
@@ -0,0 +1,227 @@
+#include "snapshot.h"
+#include "rowmapper.h"
+#include <QtSql/QSqlQuery>
+#include <QtSql/QSqlRecord>
+#include <limits>
+
+namespace {
+// Ngày không hợp lệ (NULL hoặc sai định dạng) trong cột borrowDates
+const qint64 INVALID_DATE = std::numeric_limits<qint64>::min();
+
+qint64 toMSecs(const QDateTime& date) {
+    return date.isValid() ? date.toMSecsSinceEpoch() : INVALID_DATE;
+}
+
+// Cột chuỗi của snapshot khác, trỏ vào phần pool vừa được chép tới vị trí base
+void appendRefs(std::vector<StringPool::Ref>& column, const std::vector<StringPool::Ref>& other, quint32 base) {
+    column.reserve(column.size() + other.size());
+    for (StringPool::Ref ref : other) {
+        ref.offset += base;
+        column.push_back(ref);
+    }
+}
+
+template <typename T>
+void appendColumn(std::vector<T>& column, const std::vector<T>& other) {
+    column.insert(column.end(), other.begin(), other.end());
+}
+
+template <typename T>
+void eraseAt(std::vector<T>& column, int index) {
+    column.erase(column.begin() + index);
+}
+}
+
+StringPool::Ref StringPool::add(QStringView text) {
+    Ref ref;
+    ref.offset = static_cast<quint32>(chars.size());
+    ref.length = static_cast<quint32>(text.size());
+    chars.insert(chars.end(), text.begin(), text.end());
+    return ref;
+}
+
+StringPool::Ref StringPool::intern(const QString& text) {
+    auto it = interned.constFind(text);
+    if (it != interned.constEnd()) return *it;
+    const Ref ref = add(text);
+    interned.insert(text, ref);
+    return ref;
+}
+
+quint32 StringPool::append(const StringPool& other) {
+    const quint32 base = static_cast<quint32>(chars.size());
+    chars.insert(chars.end(), other.chars.begin(), other.chars.end());
+    return base;
+}
+
+// --- BookSnapshot ---
+
+void BookSnapshot::reserve(int rows) {
+    const size_t count = static_cast<size_t>(rows);
+    isbns.reserve(count);
+    titles.reserve(count);
+    authors.reserve(count);
+    totalCopies.reserve(count);
+    availableCopies.reserve(count);
+    // Ước lượng ISBN ~14 ký tự, tên sách ~32 ký tự
+    strings.reserve(static_cast<qsizetype>(rows) * 46);
+}
+
+void BookSnapshot::append(const QString& isbn, const QString& title, const QString& author,
+                          int total, int available) {
+    isbns.push_back(strings.add(isbn));
+    titles.push_back(strings.add(title));
+    authors.push_back(strings.intern(author));
+    totalCopies.push_back(total);
+    availableCopies.push_back(available);
+}
+
+void BookSnapshot::append(const BookSnapshot& other) {
+    const quint32 base = strings.append(other.strings);
+    appendRefs(isbns, other.isbns, base);
+    appendRefs(titles, other.titles, base);
+    appendRefs(authors, other.authors, base);
+    appendColumn(totalCopies, other.totalCopies);
+    appendColumn(availableCopies, other.availableCopies);
+}
+
+void BookSnapshot::replace(int index, const Book& book) {
+    isbns[index] = strings.add(book.getIsbn());
+    titles[index] = strings.add(book.getTitle());
+    authors[index] = strings.intern(book.getAuthor());
+    totalCopies[index] = book.getTotalCopies();
+    availableCopies[index] = book.getAvailableCopies();
+}
+
+void BookSnapshot::remove(int index) {
+    eraseAt(isbns, index);
+    eraseAt(titles, index);
+    eraseAt(authors, index);
+    eraseAt(totalCopies, index);
+    eraseAt(availableCopies, index);
+}
+
+Book BookSnapshot::toBook(int index) const {
+    const Row row = (*this)[index];
+    Book book(row.isbn().toString(), row.title().toString(), row.author().toString(), row.totalCopies());
+    book.setAvailableCopies(row.availableCopies());
+    return book;
+}
+
+qsizetype BookSnapshot::memoryUsage() const {
+    const size_t refs = isbns.capacity() + titles.capacity() + authors.capacity();
+    return strings.byteSize()
+           + static_cast<qsizetype>(refs * sizeof(StringPool::Ref))
+           + static_cast<qsizetype>((totalCopies.capacity() + availableCopies.capacity()) * sizeof(qint32));
+}
+
+BookSnapshot BookSnapshot::fromQuery(QSqlQuery& query, int maxRows) {
+    using namespace RowMapperDetail;
+    const QSqlRecord record = query.record();
+    const int isbn = record.indexOf("isbn");
+    const int title = record.indexOf("title");
+    const int author = record.indexOf("author");
+    const int total = record.indexOf("total_copies");
+    const int available = record.indexOf("available_copies");
+
+    BookSnapshot snapshot;
+    if (maxRows > 0) snapshot.reserve(maxRows);
+    while (snapshot.size() != maxRows && query.next()) {
+        snapshot.append(text(query, isbn), text(query, title), text(query, author),
+                        number(query, total), number(query, available));
+    }
+    return snapshot;
+}
+
+// --- TransactionSnapshot ---
+
+void TransactionSnapshot::reserve(int rows) {
+    const size_t count = static_cast<size_t>(rows);
+    ids.reserve(count);
+    userIds.reserve(count);
+    userNames.reserve(count);
+    bookIsbns.reserve(count);
+    bookTitles.reserve(count);
+    borrowDates.reserve(count);
+    statuses.reserve(count);
+}
+
+void TransactionSnapshot::append(int id, const QString& userId, const QString& userName,
+                                 const QString& bookIsbn, const QString& bookTitle,
+                                 const QDateTime& borrowDate, TransactionStatus status) {
+    ids.push_back(id);
+    // Người dùng và sách lặp lại qua nhiều giao dịch nên đều được intern
+    userIds.push_back(strings.intern(userId));
+    userNames.push_back(strings.intern(userName));
+    bookIsbns.push_back(strings.intern(bookIsbn));
+    bookTitles.push_back(strings.intern(bookTitle));
+    borrowDates.push_back(toMSecs(borrowDate));
+    statuses.push_back(static_cast<quint8>(status));
+}
+
+void TransactionSnapshot::append(const TransactionSnapshot& other) {
+    const quint32 base = strings.append(other.strings);
+    appendColumn(ids, other.ids);
+    appendRefs(userIds, other.userIds, base);
+    appendRefs(userNames, other.userNames, base);
+    appendRefs(bookIsbns, other.bookIsbns, base);
+    appendRefs(bookTitles, other.bookTitles, base);
+    appendColumn(borrowDates, other.borrowDates);
+    appendColumn(statuses, other.statuses);
+}
+
+void TransactionSnapshot::insert(int index, const Transaction& transaction) {
+    ids.insert(ids.begin() + index, transaction.getId());
+    userIds.insert(userIds.begin() + index, strings.intern(transaction.getUserId()));
+    userNames.insert(userNames.begin() + index, strings.intern(transaction.getUserName()));
+    bookIsbns.insert(bookIsbns.begin() + index, strings.intern(transaction.getBookIsbn()));
+    bookTitles.insert(bookTitles.begin() + index, strings.intern(transaction.getBookTitle()));
+    borrowDates.insert(borrowDates.begin() + index, toMSecs(transaction.getBorrowDate()));
+    statuses.insert(statuses.begin() + index, static_cast<quint8>(transaction.getStatus()));
+}
+
+void TransactionSnapshot::remove(int index) {
+    eraseAt(ids, index);
+    eraseAt(userIds, index);
+    eraseAt(userNames, index);
+    eraseAt(bookIsbns, index);
+    eraseAt(bookTitles, index);
+    eraseAt(borrowDates, index);
+    eraseAt(statuses, index);
+}
+
+QDateTime TransactionSnapshot::Row::borrowDate() const {
+    const qint64 msecs = snapshot->borrowDates[index];
+    return msecs == INVALID_DATE ? QDateTime() : QDateTime::fromMSecsSinceEpoch(msecs);
+}
+
+qsizetype TransactionSnapshot::memoryUsage() const {
+    const size_t refs = userIds.capacity() + userNames.capacity() + bookIsbns.capacity() + bookTitles.capacity();
+    return strings.byteSize()
+           + static_cast<qsizetype>(refs * sizeof(StringPool::Ref))
+           + static_cast<qsizetype>(ids.capacity() * sizeof(qint32))
+           + static_cast<qsizetype>(borrowDates.capacity() * sizeof(qint64))
+           + static_cast<qsizetype>(statuses.capacity() * sizeof(quint8));
+}
+
+TransactionSnapshot TransactionSnapshot::fromQuery(QSqlQuery& query, int maxRows) {
+    using namespace RowMapperDetail;
+    const QSqlRecord record = query.record();
+    const int id = record.indexOf("id");
+    const int userId = record.indexOf("user_id");
+    const int userName = record.indexOf("user_name");
+    const int bookIsbn = record.indexOf("book_isbn");
+    const int bookTitle = record.indexOf("book_title");
+    const int borrowDate = record.indexOf("borrow_date");
+    const int status = record.indexOf("status");
+
+    TransactionSnapshot snapshot;
+    if (maxRows > 0) snapshot.reserve(maxRows);
+    while (snapshot.size() != maxRows && query.next()) {
+        snapshot.append(number(query, id), text(query, userId), text(query, userName),
+                        text(query, bookIsbn), text(query, bookTitle),
+                        QDateTime::fromString(text(query, borrowDate), Qt::ISODate),
+                        transactionStatus(text(query, status)));
+    }
+    return snapshot;
+}
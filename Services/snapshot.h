@@ -0,0 +1,161 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <QString>
+#include <QStringView>
+#include <QHash>
+#include <QDateTime>
+#include <vector>
+#include "Models/book.h"
+#include "Models/transaction.h"
+
+class QSqlQuery;
+
+// Bộ đệm chuỗi dùng chung cho một snapshot: mọi chuỗi nằm liền nhau trong một mảng
+// và được tham chiếu bằng (offset, length), nên không có cấp phát riêng cho từng chuỗi.
+// intern() dùng lại chuỗi đã có (tên tác giả, tên người dùng lặp lại nhiều lần).
+class StringPool {
+public:
+    struct Ref {
+        quint32 offset = 0;
+        quint32 length = 0;
+    };
+
+    Ref add(QStringView text);
+    Ref intern(const QString& text);
+    // Chép toàn bộ ký tự của pool khác vào cuối; trả về độ lệch cần cộng vào các Ref của pool đó
+    quint32 append(const StringPool& other);
+    QStringView view(Ref ref) const {
+        return QStringView(chars.data() + ref.offset, static_cast<qsizetype>(ref.length));
+    }
+
+    void reserve(qsizetype characters) { chars.reserve(static_cast<size_t>(characters)); }
+    // Số byte đang dùng cho nội dung chuỗi (không tính bảng intern)
+    qsizetype byteSize() const { return static_cast<qsizetype>(chars.capacity() * sizeof(QChar)); }
+
+private:
+    std::vector<QChar> chars;
+    QHash<QString, Ref> interned;
+};
+
+// Bộ duyệt theo chỉ số dùng chung cho các snapshot; trả về Row view theo giá trị
+template <typename Snapshot>
+class SnapshotIterator {
+public:
+    SnapshotIterator(const Snapshot* snapshot, int index) : snapshot(snapshot), index(index) {}
+    typename Snapshot::Row operator*() const { return (*snapshot)[index]; }
+    SnapshotIterator& operator++() { ++index; return *this; }
+    bool operator!=(const SnapshotIterator& other) const { return index != other.index; }
+    bool operator==(const SnapshotIterator& other) const { return index == other.index; }
+
+private:
+    const Snapshot* snapshot;
+    int index;
+};
+
+// Ảnh chụp danh mục sách dạng cột (structure-of-arrays) cho các lần đọc hàng loạt.
+// Mỗi cột là một mảng liền nhau; chuỗi nằm trong StringPool. Row chỉ là (snapshot, chỉ số),
+// các chuỗi trả về dạng QStringView và chỉ hợp lệ khi snapshot còn tồn tại.
+class BookSnapshot {
+public:
+    class Row {
+    public:
+        Row(const BookSnapshot* snapshot, int index) : snapshot(snapshot), index(index) {}
+        QStringView isbn() const { return snapshot->strings.view(snapshot->isbns[index]); }
+        QStringView title() const { return snapshot->strings.view(snapshot->titles[index]); }
+        QStringView author() const { return snapshot->strings.view(snapshot->authors[index]); }
+        int totalCopies() const { return snapshot->totalCopies[index]; }
+        int availableCopies() const { return snapshot->availableCopies[index]; }
+
+    private:
+        const BookSnapshot* snapshot;
+        int index;
+    };
+
+    void reserve(int rows);
+    void append(const QString& isbn, const QString& title, const QString& author,
+                int totalCopies, int availableCopies);
+    // Nối các dòng của snapshot khác (ví dụ lô kết quả tìm kiếm kế tiếp); chuỗi được chép theo khối
+    void append(const BookSnapshot& other);
+    // Sửa hoặc xóa một dòng tại chỗ. Chuỗi cũ vẫn nằm trong pool cho tới khi snapshot bị hủy,
+    // nên chỉ dùng cho số lần thay đổi nhỏ so với số dòng
+    void replace(int index, const Book& book);
+    void remove(int index);
+    // Tạo Book từ một dòng, khi cần đối tượng đầy đủ (ví dụ dòng đang được chọn)
+    Book toBook(int index) const;
+
+    int size() const { return static_cast<int>(isbns.size()); }
+    bool isEmpty() const { return isbns.empty(); }
+    Row operator[](int index) const { return Row(this, index); }
+    SnapshotIterator<BookSnapshot> begin() const { return {this, 0}; }
+    SnapshotIterator<BookSnapshot> end() const { return {this, size()}; }
+
+    // Tổng số byte của các cột và bộ đệm chuỗi
+    qsizetype memoryUsage() const;
+
+    // Đọc các dòng còn lại của query (cột isbn, title, author, total_copies, available_copies);
+    // maxRows >= 0 chỉ đọc tối đa chừng đó dòng tiếp theo, để nhận kết quả theo từng lô.
+    // Query nên là forward-only (mặc định của DatabaseManager) để driver không giữ lại các dòng đã đọc
+    static BookSnapshot fromQuery(QSqlQuery& query, int maxRows = -1);
+
+private:
+    StringPool strings;
+    std::vector<StringPool::Ref> isbns;
+    std::vector<StringPool::Ref> titles;
+    std::vector<StringPool::Ref> authors;
+    std::vector<qint32> totalCopies;
+    std::vector<qint32> availableCopies;
+};
+
+// Ảnh chụp danh sách giao dịch dạng cột, cùng cách tổ chức như BookSnapshot
+class TransactionSnapshot {
+public:
+    class Row {
+    public:
+        Row(const TransactionSnapshot* snapshot, int index) : snapshot(snapshot), index(index) {}
+        int id() const { return snapshot->ids[index]; }
+        QStringView userId() const { return snapshot->strings.view(snapshot->userIds[index]); }
+        QStringView userName() const { return snapshot->strings.view(snapshot->userNames[index]); }
+        QStringView bookIsbn() const { return snapshot->strings.view(snapshot->bookIsbns[index]); }
+        QStringView bookTitle() const { return snapshot->strings.view(snapshot->bookTitles[index]); }
+        QDateTime borrowDate() const;
+        TransactionStatus status() const { return static_cast<TransactionStatus>(snapshot->statuses[index]); }
+
+    private:
+        const TransactionSnapshot* snapshot;
+        int index;
+    };
+
+    void reserve(int rows);
+    void append(int id, const QString& userId, const QString& userName, const QString& bookIsbn,
+                const QString& bookTitle, const QDateTime& borrowDate, TransactionStatus status);
+    void append(const TransactionSnapshot& other);
+    // Thay đổi tại chỗ khi có giao dịch mới hoặc đổi trạng thái; giữ nguyên thứ tự các dòng khác
+    void insert(int index, const Transaction& transaction);
+    void remove(int index);
+    void setStatus(int index, TransactionStatus status) { statuses[index] = static_cast<quint8>(status); }
+
+    int size() const { return static_cast<int>(ids.size()); }
+    bool isEmpty() const { return ids.empty(); }
+    Row operator[](int index) const { return Row(this, index); }
+    SnapshotIterator<TransactionSnapshot> begin() const { return {this, 0}; }
+    SnapshotIterator<TransactionSnapshot> end() const { return {this, size()}; }
+
+    qsizetype memoryUsage() const;
+
+    // Đọc các dòng còn lại của query (giống getAllTransactionsData: t.*, user_name, book_title);
+    // maxRows >= 0 chỉ đọc tối đa chừng đó dòng và để query đứng ở dòng cuối cùng đã đọc
+    static TransactionSnapshot fromQuery(QSqlQuery& query, int maxRows = -1);
+
+private:
+    StringPool strings;
+    std::vector<qint32> ids;
+    std::vector<StringPool::Ref> userIds;
+    std::vector<StringPool::Ref> userNames;
+    std::vector<StringPool::Ref> bookIsbns;
+    std::vector<StringPool::Ref> bookTitles;
+    std::vector<qint64> borrowDates; // Mili giây kể từ epoch
+    std::vector<quint8> statuses;
+};
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,72 @@
+#include "statisticsprovider.h"
+#include "warmstartcache.h"
+#include <QDataStream>
+
+namespace {
+// Khoảng tối thiểu giữa hai lần đọc số liệu
+const int MIN_INTERVAL_MS = 1000;
+const QString SNAPSHOT_NAME = "statistics";
+}
+
+StatisticsProvider::StatisticsProvider(QObject* parent) : QObject(parent) {
+    throttleTimer.setSingleShot(true);
+    throttleTimer.setInterval(MIN_INTERVAL_MS);
+    connect(&throttleTimer, &QTimer::timeout, this, [this]() {
+        if (pending) recompute();
+    });
+}
+
+void StatisticsProvider::requestUpdate() {
+    // Đang đọc hoặc vừa đọc xong: gộp vào lần đọc kế tiếp
+    if (computing || throttleTimer.isActive()) {
+        pending = true;
+        return;
+    }
+    recompute();
+}
+
+void StatisticsProvider::recompute() {
+    pending = false;
+    computing = true;
+    throttleTimer.start();
+
+    DatabaseManager::getInstance().executor().run([]() {
+        return DatabaseManager::getInstance().getStatistics();
+    }).then(this, [this](const LibraryStatistics& statistics) {
+        computing = false;
+        if (!loaded || statistics != current) {
+            loaded = true;
+            current = statistics;
+            emit statisticsChanged(current);
+        }
+        // Có thay đổi trong lúc đọc và khoảng chờ đã hết: đọc lại ngay
+        if (pending && !throttleTimer.isActive()) recompute();
+    });
+}
+
+bool StatisticsProvider::restoreSnapshot() {
+    const QByteArray payload = WarmStartCache::load(SNAPSHOT_NAME);
+    if (payload.isEmpty()) return false;
+
+    LibraryStatistics statistics;
+    QDataStream in(payload);
+    in >> statistics.totalBooks >> statistics.totalUsers
+       >> statistics.activeTransactions >> statistics.overdueTransactions;
+    if (in.status() != QDataStream::Ok) return false;
+
+    // Không ghi đè số liệu đã đọc từ database
+    if (loaded) return true;
+    loaded = true;
+    current = statistics;
+    emit statisticsChanged(current);
+    return true;
+}
+
+void StatisticsProvider::saveSnapshot() const {
+    if (!loaded) return;
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out << current.totalBooks << current.totalUsers << current.activeTransactions << current.overdueTransactions;
+    WarmStartCache::save(SNAPSHOT_NAME, payload);
+}
@@ -0,0 +1,43 @@
+#ifndef STATISTICSPROVIDER_H
+#define STATISTICSPROVIDER_H
+
+#include <QObject>
+#include <QTimer>
+#include "databasemanager.h"
+
+// Nguồn số liệu thống kê dùng chung cho giao diện.
+// requestUpdate() được gọi mỗi khi dữ liệu thay đổi; số liệu được đọc trên luồng worker database
+// (một truy vấn vào library_stats) và các yêu cầu dồn dập được gộp lại: tối đa một lần đọc
+// trong mỗi khoảng MIN_INTERVAL, yêu cầu đến trong lúc chờ được xử lý bằng một lần đọc ở cuối khoảng.
+// statisticsChanged chỉ được phát khi số liệu thực sự khác lần trước.
+class StatisticsProvider : public QObject {
+    Q_OBJECT
+public:
+    explicit StatisticsProvider(QObject* parent = nullptr);
+
+    // Số liệu gần nhất; hasStatistics() = false nếu chưa đọc lần nào.
+    // Sau restoreSnapshot() đây có thể là số liệu của lần chạy trước cho tới khi requestUpdate() đọc lại.
+    bool hasStatistics() const { return loaded; }
+    LibraryStatistics statistics() const { return current; }
+
+    // Ảnh chụp khởi động nhanh (xem WarmStartCache); restoreSnapshot trả về false nếu không có
+    bool restoreSnapshot();
+    void saveSnapshot() const;
+
+public slots:
+    void requestUpdate();
+
+signals:
+    void statisticsChanged(const LibraryStatistics& statistics);
+
+private:
+    void recompute();
+
+    QTimer throttleTimer;
+    bool computing = false;
+    bool pending = false;
+    bool loaded = false;
+    LibraryStatistics current;
+};
+
+#endif // STATISTICSPROVIDER_H
@@ -0,0 +1,16 @@
+#include "textnormalizer.h"
+
+namespace TextNormalizer {
+QString normalize(const QString& text) {
+    const QString decomposed = text.toCaseFolded().normalized(QString::NormalizationForm_KD);
+
+    QString result;
+    result.reserve(decomposed.size());
+    for (QChar ch : decomposed) {
+        if (ch.category() == QChar::Mark_NonSpacing) continue;
+        // "đ" không có dạng tách dấu trong Unicode nên phải đổi thủ công
+        result.append(ch == QChar(0x0111) ? QChar('d') : ch);
+    }
+    return result.simplified();
+}
+}
@@ -0,0 +1,14 @@
+#ifndef TEXTNORMALIZER_H
+#define TEXTNORMALIZER_H
+
+#include <QString>
+
+// Chuẩn hóa văn bản cho tìm kiếm không phân biệt dấu và hoa/thường:
+// casefold, tách dấu (NFKD) rồi bỏ các dấu kết hợp, đổi "đ" thành "d", gộp khoảng trắng.
+// Ví dụ: "Tiếng Việt" -> "tieng viet", "ĐƯỜNG" -> "duong".
+// Dùng cùng một hàm khi ghi (cột *_norm) và khi tìm kiếm để hai phía luôn khớp nhau.
+namespace TextNormalizer {
+QString normalize(const QString& text);
+}
+
+#endif // TEXTNORMALIZER_H
@@ -0,0 +1,37 @@
+#ifndef TRANSACTIONFILTER_H
+#define TRANSACTIONFILTER_H
+
+#include <QDateTime>
+#include <QString>
+#include <optional>
+#include "Models/transaction.h"
+
+// Giá trị cột status trong bảng transactions
+inline QString transactionStatusText(TransactionStatus status) {
+    switch (status) {
+    case TransactionStatus::Completed: return QStringLiteral("Completed");
+    case TransactionStatus::Overdue: return QStringLiteral("Overdue");
+    case TransactionStatus::Active:
+    default: return QStringLiteral("Active");
+    }
+}
+
+// Điều kiện lọc lịch sử giao dịch, được áp dụng trong SQL (xem DatabaseManager::getTransactionsPageData).
+// Ngày mượn nằm trong [from, to); mốc không hợp lệ nghĩa là không giới hạn phía đó.
+struct TransactionFilter {
+    std::optional<TransactionStatus> status;
+    QDateTime from;
+    QDateTime to;
+
+    bool isEmpty() const { return !status && !from.isValid() && !to.isValid(); }
+
+    // Cùng điều kiện với SQL: dùng để biết một giao dịch vừa thêm/cập nhật có thuộc danh sách đang lọc không
+    bool matches(const Transaction& transaction) const {
+        if (status && transaction.getStatus() != *status) return false;
+        if (from.isValid() && transaction.getBorrowDate() < from) return false;
+        if (to.isValid() && transaction.getBorrowDate() >= to) return false;
+        return true;
+    }
+};
+
+#endif // TRANSACTIONFILTER_H
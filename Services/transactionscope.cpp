@@ -0,0 +1,31 @@
+#include "transactionscope.h"
+#include "databasemanager.h"
+
+TransactionScope::TransactionScope() : TransactionScope(DatabaseManager::getInstance()) {
+}
+
+TransactionScope::TransactionScope(DatabaseManager& db) : db(db), active(false) {
+    active = db.beginTransaction();
+}
+
+TransactionScope::~TransactionScope() {
+    if (active) {
+        rollback();
+    }
+}
+
+bool TransactionScope::commit() {
+    if (!active) return false;
+    // Nếu commit thất bại, transaction vẫn mở và sẽ được rollback khi hủy scope
+    if (db.commitTransaction()) {
+        active = false;
+        return true;
+    }
+    return false;
+}
+
+void TransactionScope::rollback() {
+    if (!active) return;
+    db.rollbackTransaction();
+    active = false;
+}
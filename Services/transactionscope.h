@@ -0,0 +1,30 @@
+#ifndef TRANSACTIONSCOPE_H
+#define TRANSACTIONSCOPE_H
+
+class DatabaseManager;
+
+// Transaction theo kiểu RAII trên kết nối của luồng hiện tại.
+// Bắt đầu khi khởi tạo, phải commit() tường minh, tự rollback khi bị hủy nếu chưa commit.
+// Các scope lồng nhau trên cùng luồng được ánh xạ thành SAVEPOINT, nên chỉ
+// scope ngoài cùng mới thực sự ghi xuống đĩa (một lần commit cho cả lô).
+class TransactionScope {
+public:
+    TransactionScope();
+    explicit TransactionScope(DatabaseManager& db);
+    ~TransactionScope();
+
+    TransactionScope(const TransactionScope&) = delete;
+    TransactionScope& operator=(const TransactionScope&) = delete;
+
+    // true nếu transaction đã bắt đầu và chưa kết thúc
+    bool isActive() const { return active; }
+
+    bool commit();
+    void rollback();
+
+private:
+    DatabaseManager& db;
+    bool active;
+};
+
+#endif // TRANSACTIONSCOPE_H
@@ -0,0 +1,46 @@
+#ifndef USERDIRECTORY_H
+#define USERDIRECTORY_H
+
+#include <QString>
+#include <vector>
+#include "pagination.h"
+
+// Một dòng trong danh sách quản lý người dùng (không chứa mật khẩu)
+struct UserSummary {
+    QString id;
+    QString name;
+    QString email;
+    QString userType;
+    QString status;
+    int activeLoans = 0;
+};
+
+// Các cột có index để sắp xếp và phân trang keyset; khóa phụ luôn là id
+enum class UserSortColumn { Name, Email, Id };
+
+// Điều kiện lọc danh sách người dùng, được áp dụng trong SQL (xem DatabaseManager::getUsersPageData).
+// Chuỗi rỗng nghĩa là không lọc theo điều kiện đó.
+struct UserFilter {
+    QString userType; // "Student", "Faculty", "Librarian"
+    QString status;   // "Active", "Inactive", "Suspended"
+    // Tìm theo tên (không phân biệt dấu), email hoặc ID, khớp tiền tố từng từ qua chỉ mục users_fts
+    QString text;
+    UserSortColumn sortColumn = UserSortColumn::Name;
+    Qt::SortOrder sortOrder = Qt::AscendingOrder;
+};
+
+// Số người dùng thỏa điều kiện lọc, đếm bằng một truy vấn tổng hợp
+struct UserCounts {
+    int total = 0;
+    int active = 0;
+};
+
+// Một trang người dùng đọc trên luồng worker; số đếm chỉ có ở trang đầu tiên (đọc khi đổi điều kiện lọc)
+struct UserListing {
+    std::vector<UserSummary> users;
+    PageCursor last;
+    bool hasMore = false;
+    UserCounts counts;
+};
+
+#endif // USERDIRECTORY_H
@@ -0,0 +1,54 @@
+#include "warmstartcache.h"
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+namespace {
+const quint32 MAGIC = 0x4c575353; // "LWSS"
+// Tăng khi định dạng payload của bất kỳ màn hình nào thay đổi; ảnh chụp cũ sẽ bị bỏ qua
+const quint32 FORMAT_VERSION = 1;
+
+// Cùng thư mục với database (xem DatabaseManager::initialize)
+QString snapshotPath(const QString& name) {
+    return QCoreApplication::applicationDirPath() + "/warmstart/" + name + ".snapshot";
+}
+}
+
+namespace WarmStartCache {
+QByteArray load(const QString& name) {
+    QFile file(snapshotPath(name));
+    if (!file.open(QIODevice::ReadOnly)) return QByteArray();
+
+    QDataStream in(&file);
+    quint32 magic = 0;
+    quint32 version = 0;
+    QByteArray payload;
+    in >> magic >> version >> payload;
+    if (in.status() != QDataStream::Ok || magic != MAGIC || version != FORMAT_VERSION) {
+        qWarning() << "Ignoring unreadable warm-start snapshot" << name;
+        return QByteArray();
+    }
+    return payload;
+}
+
+bool save(const QString& name, const QByteArray& payload) {
+    const QString path = snapshotPath(name);
+    if (!QDir().mkpath(QFileInfo(path).absolutePath())) {
+        qWarning() << "Could not create warm-start directory for" << path;
+        return false;
+    }
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Could not write warm-start snapshot" << path << file.errorString();
+        return false;
+    }
+    QDataStream out(&file);
+    out << MAGIC << FORMAT_VERSION << payload;
+    return out.status() == QDataStream::Ok && file.commit();
+}
+}
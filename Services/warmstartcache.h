@@ -0,0 +1,18 @@
+#ifndef WARMSTARTCACHE_H
+#define WARMSTARTCACHE_H
+
+#include <QByteArray>
+#include <QString>
+
+// Ảnh chụp trạng thái của các màn hình, được ghi khi đóng cửa sổ chính và đọc lại ở lần
+// mở sau để hiển thị ngay, trước khi dữ liệu thật được đọc từ database ở nền.
+// Mỗi ảnh chụp là một file trong thư mục "warmstart" cạnh database; nội dung (payload)
+// do màn hình tự tuần tự hóa. Ảnh chụp chỉ là gợi ý: người dùng luôn phải đối chiếu lại.
+namespace WarmStartCache {
+// Mảng rỗng nếu chưa có ảnh chụp hoặc file không đúng định dạng
+QByteArray load(const QString& name);
+// Ghi nguyên tử (file tạm rồi đổi tên) để không để lại ảnh chụp dở dang
+bool save(const QString& name, const QByteArray& payload);
+}
+
+#endif // WARMSTARTCACHE_H
@@ -1,4 +1,6 @@
 #include <QApplication>
+#include <QDebug>
+#include <QElapsedTimer>
 #include <QMessageBox>
 #include "GUI/loginwidget.h"
 #include "GUI/mainwindow.h"
@@ -6,6 +8,10 @@
 #include "Services/libraryservice.h"
 
 int main(int argc, char *argv[]) {
+    // Thời gian khởi động từng giai đoạn được ghi log để theo dõi khi dữ liệu lớn dần
+    QElapsedTimer startupTimer;
+    startupTimer.start();
+
     QApplication app(argc, argv);
     app.setApplicationName("EduLibraryManager");
     app.setOrganizationName("EduSolutions");
@@ -15,9 +21,11 @@ int main(int argc, char *argv[]) {
         QMessageBox::critical(nullptr, "Lỗi Database", "Không thể khởi tạo cơ sở dữ liệu.");
         return -1;
     }
+    qInfo() << "Startup: database ready after" << startupTimer.elapsed() << "ms";
 
     LibraryService libraryService;
     libraryService.seedDatabaseFromResources();
+    qInfo() << "Startup: library service ready after" << startupTimer.elapsed() << "ms";
 
     LoginWidget loginWidget(libraryService);
     MainWindow* mainWindow = nullptr;
@@ -26,13 +34,17 @@ int main(int argc, char *argv[]) {
     QObject::connect(&loginWidget, &LoginWidget::loginSuccessful,
                      [&]() {
                          // User đã được đặt trong libraryService
+                         QElapsedTimer windowTimer;
+                         windowTimer.start();
                          mainWindow = new MainWindow(libraryService);
                          mainWindow->setAttribute(Qt::WA_DeleteOnClose);
                          mainWindow->show();
                          loginWidget.close();
+                         qInfo() << "Startup: main window shown" << windowTimer.elapsed() << "ms after login";
                      });
 
     loginWidget.show();
+    qInfo() << "Startup: login window shown after" << startupTimer.elapsed() << "ms";
 
     int result = app.exec();
     dbManager.close();
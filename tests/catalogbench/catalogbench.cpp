@@ -0,0 +1,174 @@
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QDebug>
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "Models/book.h"
+#include "Services/databasemanager.h"
+#include "Services/rowmapper.h"
+#include "Services/snapshot.h"
+#include "Services/transactionscope.h"
+
+// Đo thời gian đọc toàn bộ danh mục sách từ database theo từng cách giải mã dòng,
+// và so sánh BookSnapshot (dạng cột) với std::vector<std::unique_ptr<Book>> về bộ nhớ và tốc độ duyệt.
+// Chạy: catalogbench [số sách], mặc định 1 000 000 (cỡ danh mục mà BookSnapshot nhắm tới);
+// truyền số nhỏ hơn để chạy nhanh. Mỗi phép đo lấy thời gian tốt nhất của REPEATS lần.
+
+namespace {
+const QString DATABASE_NAME = "catalog_bench.db";
+const int DEFAULT_BOOK_COUNT = 1000000;
+const int BATCH_SIZE = 100;
+const int REPEATS = 5;
+
+// Chi phí quản lý của mỗi khối malloc (glibc 64-bit); chỉ dùng cho ước lượng bộ nhớ
+const qsizetype MALLOC_OVERHEAD = 16;
+
+// Giữ kết quả của mỗi lần chạy để trình biên dịch không bỏ qua phần giải mã
+volatile qint64 sink = 0;
+
+template <typename Function>
+double bestOfMs(Function function) {
+    double best = std::numeric_limits<double>::max();
+    for (int i = 0; i < REPEATS; ++i) {
+        QElapsedTimer timer;
+        timer.start();
+        sink += function();
+        best = std::min(best, timer.nsecsElapsed() / 1e6);
+    }
+    return best;
+}
+
+void report(const char* name, double ms, int rows) {
+    qInfo().noquote() << QString("%1 %2 ms  (%3 rows/s)")
+                             .arg(QLatin1String(name), -36)
+                             .arg(ms, 8, 'f', 2)
+                             .arg(rows / (ms / 1000.0), 0, 'f', 0);
+}
+
+void removeDatabase() {
+    const QString path = QCoreApplication::applicationDirPath() + "/" + DATABASE_NAME;
+    for (const QString& suffix : {QString(), QString("-wal"), QString("-shm")}) {
+        QFile::remove(path + suffix);
+    }
+}
+
+bool seedCatalog(DatabaseManager& db, int bookCount) {
+    TransactionScope scope(db);
+    if (!scope.isActive()) return false;
+
+    std::vector<Book> batch;
+    batch.reserve(BATCH_SIZE);
+    for (int i = 0; i < bookCount; ++i) {
+        batch.emplace_back(QString("978-%1").arg(i, 9, 10, QChar('0')),
+                           QString("Benchmark Title %1").arg(static_cast<qint64>(i) * 7919 % bookCount),
+                           QString("Author %1").arg(i % 997), 1 + i % 5);
+        if (static_cast<int>(batch.size()) == BATCH_SIZE || i == bookCount - 1) {
+            if (db.saveNewBooks(batch) < 0) return false;
+            batch.clear();
+        }
+    }
+    return scope.commit();
+}
+
+// Mỗi QString đọc từ database có khối dữ liệu riêng: header QArrayData + ký tự + '\0'
+qsizetype stringBytes(const QString& text) {
+    if (text.isNull()) return 0;
+    return static_cast<qsizetype>(sizeof(QArrayData)) + (text.capacity() + 1) * static_cast<qsizetype>(sizeof(QChar))
+           + MALLOC_OVERHEAD;
+}
+
+// Ước lượng bộ nhớ heap của danh sách sách dạng đối tượng: con trỏ, một khối Book cho mỗi sách
+// và ba chuỗi riêng của nó. So sánh được với BookSnapshot::memoryUsage() (không tính header của vector)
+qsizetype bookListBytes(const std::vector<std::unique_ptr<Book>>& books) {
+    qsizetype bytes = static_cast<qsizetype>(books.capacity() * sizeof(std::unique_ptr<Book>));
+    for (const auto& book : books) {
+        bytes += static_cast<qsizetype>(sizeof(Book)) + MALLOC_OVERHEAD;
+        bytes += stringBytes(book->getIsbn()) + stringBytes(book->getTitle()) + stringBytes(book->getAuthor());
+    }
+    return bytes;
+}
+
+// Cách giải mã trước RowMapper: tra tên cột ở mỗi dòng
+std::unique_ptr<Book> bookByColumnName(const QSqlQuery& query) {
+    auto book = std::make_unique<Book>(query.value("isbn").toString(), query.value("title").toString(),
+                                       query.value("author").toString(), query.value("total_copies").toInt());
+    book->setAvailableCopies(query.value("available_copies").toInt());
+    return book;
+}
+}
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    const QStringList arguments = app.arguments();
+    const int bookCount = arguments.size() > 1 ? std::max(1, arguments.at(1).toInt()) : DEFAULT_BOOK_COUNT;
+
+    removeDatabase();
+    DatabaseManager& db = DatabaseManager::getInstance();
+    if (!db.initialize(DATABASE_NAME) || !seedCatalog(db, bookCount)) {
+        qCritical() << "Could not prepare benchmark database";
+        return 1;
+    }
+    qInfo() << "Catalog of" << bookCount << "books, best of" << REPEATS << "runs";
+
+    report("decode by column name", bestOfMs([&db]() {
+        ScopedQuery query = db.getAllBooksData();
+        std::vector<std::unique_ptr<Book>> books;
+        while (query.next()) {
+            books.push_back(bookByColumnName(query));
+        }
+        return static_cast<qint64>(books.size());
+    }), bookCount);
+
+    report("RowMapper<Book> (mapRows)", bestOfMs([&db]() {
+        ScopedQuery query = db.getAllBooksData();
+        return static_cast<qint64>(mapRows<Book>(query).size());
+    }), bookCount);
+
+    report("BookSnapshot::fromQuery", bestOfMs([&db]() {
+        ScopedQuery query = db.getAllBooksData();
+        return static_cast<qint64>(BookSnapshot::fromQuery(query).size());
+    }), bookCount);
+
+    // Cùng dữ liệu ở hai dạng, dùng cho phép đo bộ nhớ và tốc độ duyệt
+    std::vector<std::unique_ptr<Book>> books;
+    BookSnapshot snapshot;
+    {
+        ScopedQuery query = db.getAllBooksData();
+        books = mapRows<Book>(query);
+    }
+    {
+        ScopedQuery query = db.getAllBooksData();
+        snapshot = BookSnapshot::fromQuery(query);
+    }
+    // Getter của Book trả về bản sao QString (chỉ tăng bộ đếm tham chiếu), còn Row trả về QStringView
+    report("scan std::vector<unique_ptr<Book>>", bestOfMs([&books]() {
+        qint64 total = 0;
+        for (const auto& book : books) {
+            total += book->getAvailableCopies() + book->getTitle().size();
+        }
+        return total;
+    }), bookCount);
+
+    report("scan BookSnapshot", bestOfMs([&snapshot]() {
+        qint64 total = 0;
+        for (const BookSnapshot::Row row : snapshot) {
+            total += row.availableCopies() + row.title().size();
+        }
+        return total;
+    }), bookCount);
+
+    const qsizetype objectBytes = bookListBytes(books);
+    const qsizetype snapshotBytes = snapshot.memoryUsage();
+    qInfo().noquote() << QString("memory std::vector<unique_ptr<Book>> ~%1 KiB (estimated, %2 heap blocks)")
+                             .arg(objectBytes / 1024).arg(static_cast<qint64>(books.size()) * 4 + 1);
+    qInfo().noquote() << QString("memory BookSnapshot                  %1 KiB (6 heap blocks + author intern table), %2x smaller")
+                             .arg(snapshotBytes / 1024)
+                             .arg(static_cast<double>(objectBytes) / std::max<qsizetype>(snapshotBytes, 1), 0, 'f', 1);
+
+    db.close();
+    removeDatabase();
+    return 0;
+}
@@ -0,0 +1,8 @@
+TARGET = catalogbench
+TEMPLATE = app
+
+include(../database.pri)
+
+SOURCES += \
+    $$ROOT/Services/snapshot.cpp \
+    catalogbench.cpp
@@ -0,0 +1,9 @@
+QT += testlib
+CONFIG += testcase
+TARGET = tst_circulationstress
+TEMPLATE = app
+
+include(../database.pri)
+
+SOURCES += \
+    tst_circulationstress.cpp
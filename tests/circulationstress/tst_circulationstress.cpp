@@ -0,0 +1,163 @@
+#include <QtTest>
+#include <QFile>
+#include <QRandomGenerator>
+#include <QThread>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "Models/book.h"
+#include "Models/student.h"
+#include "Models/transaction.h"
+#include "Services/databasemanager.h"
+
+namespace {
+const QString DATABASE_NAME = "circulation_stress.db";
+const QString ISBN = "978-0-00-000000-0";
+const int TOTAL_COPIES = 3;
+const int WORKER_COUNT = 8;
+const int ITERATIONS_PER_WORKER = 300;
+const int MAX_LOANS = 5;
+
+QString userIdFor(int worker) {
+    return QString("STRESS%1").arg(worker, 3, 10, QChar('0'));
+}
+}
+
+// Nhiều luồng, mỗi luồng một kết nối riêng từ ConnectionPool, cùng mượn/trả một đầu sách.
+// Bất biến available_copies + số khoản đang mượn == total_copies phải luôn đúng,
+// cả trong lúc chạy (luồng kiểm tra đọc snapshot WAL nhất quán) lẫn sau khi kết thúc.
+class CirculationStressTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void concurrentBorrowAndReturnKeepsCopyCounts();
+
+private:
+    // available_copies + số giao dịch chưa trả của ISBN, đọc trong một câu lệnh; -1 nếu lỗi
+    static int countedCopies(DatabaseManager& db);
+    QString databasePath() const;
+};
+
+QString CirculationStressTest::databasePath() const {
+    return QCoreApplication::applicationDirPath() + "/" + DATABASE_NAME;
+}
+
+void CirculationStressTest::initTestCase() {
+    for (const QString& suffix : {QString(), QString("-wal"), QString("-shm")}) {
+        QFile::remove(databasePath() + suffix);
+    }
+
+    DatabaseManager& db = DatabaseManager::getInstance();
+    QVERIFY(db.initialize(DATABASE_NAME));
+    QVERIFY(db.saveNewBook(Book(ISBN, "Stress Test Book", "Nobody", TOTAL_COPIES)));
+    for (int worker = 0; worker < WORKER_COUNT; ++worker) {
+        const QString id = userIdFor(worker);
+        const Student student("Stress " + id, id.toLower() + "@stress.test", QString(), id);
+        QVERIFY(db.saveNewUser(student, "unused"));
+    }
+}
+
+void CirculationStressTest::cleanupTestCase() {
+    DatabaseManager::getInstance().close();
+    for (const QString& suffix : {QString(), QString("-wal"), QString("-shm")}) {
+        QFile::remove(databasePath() + suffix);
+    }
+}
+
+int CirculationStressTest::countedCopies(DatabaseManager& db) {
+    ScopedQuery query = db.executeQuery(
+        "SELECT b.available_copies + (SELECT COUNT(*) FROM transactions t "
+        "WHERE t.book_isbn = b.isbn AND t.status IN ('Active', 'Overdue')) "
+        "FROM books b WHERE b.isbn = ?", {ISBN});
+    return query.next() ? query.value(0).toInt() : -1;
+}
+
+void CirculationStressTest::concurrentBorrowAndReturnKeepsCopyCounts() {
+    std::atomic<int> borrowed{0};
+    std::atomic<int> returned{0};
+    std::atomic<int> failedReturns{0};
+    std::atomic<int> invariantViolations{0};
+    std::atomic<bool> running{true};
+
+    std::vector<std::unique_ptr<QThread>> workers;
+    for (int worker = 0; worker < WORKER_COUNT; ++worker) {
+        workers.emplace_back(QThread::create([&, worker]() {
+            DatabaseManager& db = DatabaseManager::getInstance();
+            const QString userId = userIdFor(worker);
+            std::vector<int> openLoans;
+            auto* random = QRandomGenerator::global();
+
+            for (int i = 0; i < ITERATIONS_PER_WORKER; ++i) {
+                const bool tryBorrow = openLoans.empty() || (static_cast<int>(openLoans.size()) < MAX_LOANS && random->bounded(2) == 0);
+                if (tryBorrow) {
+                    int transactionId = 0;
+                    // Hết sách là kết quả hợp lệ khi nhiều luồng cùng tranh một đầu sách
+                    if (db.checkoutBook(Transaction(0, userId, ISBN), MAX_LOANS, &transactionId)) {
+                        openLoans.push_back(transactionId);
+                        ++borrowed;
+                    }
+                } else {
+                    const int transactionId = openLoans.back();
+                    openLoans.pop_back();
+                    if (db.checkinBook(transactionId)) {
+                        ++returned;
+                    } else {
+                        ++failedReturns;
+                    }
+                }
+            }
+            // Trả hết để kiểm tra số bản quay về total_copies
+            for (int transactionId : openLoans) {
+                if (db.checkinBook(transactionId)) {
+                    ++returned;
+                } else {
+                    ++failedReturns;
+                }
+            }
+        }));
+    }
+
+    // Luồng kiểm tra: mỗi lần đọc thấy một snapshot đã commit nên bất biến phải đúng ở mọi thời điểm
+    std::unique_ptr<QThread> checker(QThread::create([&]() {
+        DatabaseManager& db = DatabaseManager::getInstance();
+        while (running.load()) {
+            if (countedCopies(db) != TOTAL_COPIES) {
+                ++invariantViolations;
+            }
+            QThread::msleep(1);
+        }
+    }));
+
+    checker->start();
+    for (auto& thread : workers) {
+        thread->start();
+    }
+    for (auto& thread : workers) {
+        QVERIFY(thread->wait(QDeadlineTimer(120000)));
+    }
+    running = false;
+    QVERIFY(checker->wait(QDeadlineTimer(10000)));
+
+    qInfo() << "Borrowed" << borrowed.load() << "returned" << returned.load()
+            << "across" << WORKER_COUNT << "threads";
+
+    DatabaseManager& db = DatabaseManager::getInstance();
+    QCOMPARE(invariantViolations.load(), 0);
+    QCOMPARE(failedReturns.load(), 0);
+    QVERIFY(borrowed.load() > 0);
+    QCOMPARE(returned.load(), borrowed.load());
+    QCOMPARE(countedCopies(db), TOTAL_COPIES);
+
+    {
+        ScopedQuery book = db.getBookDataByIsbn(ISBN);
+        QVERIFY(book.next());
+        QCOMPARE(book.value("available_copies").toInt(), TOTAL_COPIES);
+    }
+    QVERIFY(db.verifyCopyCounts());
+    QVERIFY(db.verifyActiveLoans());
+}
+
+QTEST_GUILESS_MAIN(CirculationStressTest)
+#include "tst_circulationstress.moc"
@@ -0,0 +1,20 @@
+# Tầng database dùng chung cho các target kiểm thử (không gồm LibraryService và GUI)
+QT += core sql concurrent
+QT -= gui
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+ROOT = $$PWD/..
+INCLUDEPATH += $$ROOT
+
+SOURCES += \
+    $$ROOT/Models/person.cpp \
+    $$ROOT/Models/student.cpp \
+    $$ROOT/Models/book.cpp \
+    $$ROOT/Models/transaction.cpp \
+    $$ROOT/Services/databasemanager.cpp \
+    $$ROOT/Services/connectionpool.cpp \
+    $$ROOT/Services/schemamigrator.cpp \
+    $$ROOT/Services/transactionscope.cpp \
+    $$ROOT/Services/databaseexecutor.cpp \
+    $$ROOT/Services/textnormalizer.cpp
@@ -0,0 +1,8 @@
+TEMPLATE = subdirs
+
+# Kiểm thử và đo đạc chạy riêng, không cần GUI:
+#   qmake tests/tests.pro && make && make check
+# Các target đo đạc (catalogbench) không thuộc make check, chạy trực tiếp file thực thi.
+SUBDIRS += \
+    circulationstress \
+    catalogbench